@@ -0,0 +1,501 @@
+/**
+ * Policies of the Simulated Annealing run: the move set that builds a
+ * neighbor, the acceptance rule and the cooling schedule. The run is a
+ * template over one policy of each kind, so their calls are inlined in
+ * the search loop; SimulatedAnnealing::create() picks the combination by
+ * name at run time.
+ */
+#ifndef ANNEALING_POLICIES_H
+#define ANNEALING_POLICIES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Instrumentation.h"
+#include "Random.h"
+#include "State.h"
+
+// Policies of a run, by name
+struct AnnealingPolicies
+{
+    std::string moves = "mixed";
+    std::string acceptance = "metropolis";
+    std::string schedule = "geometric";
+
+    // Value minimized by the search, "colors" (the number of colors) or
+    // "class-sizes" (color_weight * colors - sum of squared class sizes)
+    std::string objective = "colors";
+    double color_weight = 0;
+
+    // Length of the late acceptance history
+    unsigned int history_length = 50;
+
+    // Adaptive schedule: acceptance ratio of worse neighbors at the initial
+    // temperature, temperature steps without improvement before reheating,
+    // and fruitless reheats before stopping
+    double initial_acceptance = 0.8;
+    unsigned int stagnation_steps = 1000;
+    unsigned int max_reheats = 1;
+
+    /**
+     * @brief Returns the registry key of this combination, "moves/acceptance/schedule"
+     */
+    std::string getKey() const
+    {
+        return this->moves + "/" + this->acceptance + "/" + this->schedule;
+    }
+};
+
+// Values the policies are built from
+struct PolicyParameters
+{
+    double temperature;
+    double constant;
+    double cooling_factor;
+    unsigned long max_iterations;
+    unsigned int history_length;
+    double initial_acceptance;
+    unsigned int stagnation_steps;
+    unsigned int max_reheats;
+};
+
+// What happened during a temperature step, for the schedules
+struct StepFeedback
+{
+    unsigned long iteration_number;
+
+    // Neighbors accepted and evaluated
+    unsigned int accepted;
+    unsigned int evaluated;
+
+    // The same, counting only neighbors worse than the current state
+    unsigned int uphill_accepted;
+    unsigned int uphill_evaluated;
+
+    // If the best state improved
+    bool improved;
+};
+
+// OBJECTIVE
+
+// Cost of a state: the number of colors, or with class sizes the number of
+// colors times a weight minus the sum of squared class sizes (Johnson et
+// al.), which rewards moves that empty small classes where the number of
+// colors alone is flat
+struct Objective
+{
+    double color_weight;
+    double size_weight;
+
+    Objective(const AnnealingPolicies &policies)
+    {
+        bool sizes = policies.objective == "class-sizes";
+
+        this->color_weight = sizes ? policies.color_weight : 1;
+        this->size_weight = sizes ? 1 : 0;
+    }
+
+    template <typename Index>
+    inline double cost(BasicState<Index> *state)
+    {
+        return this->color_weight * state->getValue() - this->size_weight * state->getSquaredSizes();
+    }
+};
+
+// MOVE SETS
+
+// Recolors a random vertex, and one in five times rebuilds the coloring
+// with Iterated Greedy
+struct MixedMoves
+{
+    static constexpr const char *NAME = "mixed";
+
+    MixedMoves(const PolicyParameters &) {}
+
+    template <typename Index>
+    inline void apply(BasicState<Index> *neighbor, Random &rng)
+    {
+        neighbor->randomizeVertexColor(1, rng);
+        INSTRUMENT_COUNT(COUNTER_RANDOMIZE_MOVES);
+
+        if (rng.uniform() >= 0.8)
+        {
+            INSTRUMENT_PHASE(PHASE_LOCAL_SEARCH);
+            neighbor->iteratedGreedy(rng);
+            INSTRUMENT_COUNT(COUNTER_LOCAL_SEARCH_MOVES);
+        }
+    }
+};
+
+// Only recolors a random vertex
+struct RecolorMoves
+{
+    static constexpr const char *NAME = "recolor";
+
+    RecolorMoves(const PolicyParameters &) {}
+
+    template <typename Index>
+    inline void apply(BasicState<Index> *neighbor, Random &rng)
+    {
+        neighbor->randomizeVertexColor(1, rng);
+        INSTRUMENT_COUNT(COUNTER_RANDOMIZE_MOVES);
+    }
+};
+
+// ACCEPTANCE RULES, given the current and the neighbor costs. Acceptance
+// rules and cooling schedules save their internal state into checkpoints,
+// and restore() rejects a state saved by another policy
+
+// Accepts worse neighbors with probability e ^ -(f(s') - f(s)) / k * t
+struct MetropolisAcceptance
+{
+    static constexpr const char *NAME = "metropolis";
+
+    MetropolisAcceptance(const PolicyParameters &) {}
+
+    void save(std::vector<double> &state) const
+    {
+        state.clear();
+    }
+
+    bool restore(const std::vector<double> &state)
+    {
+        return state.empty();
+    }
+
+    inline bool accept(double current_cost, double neighbor_cost, double prob_kt, Random &rng)
+    {
+        return neighbor_cost <= current_cost ||
+               rng.uniform() < std::exp(-(neighbor_cost - current_cost) / prob_kt);
+    }
+};
+
+// Accepts neighbors that are worse by less than k * t
+struct ThresholdAcceptance
+{
+    static constexpr const char *NAME = "threshold";
+
+    ThresholdAcceptance(const PolicyParameters &) {}
+
+    void save(std::vector<double> &state) const
+    {
+        state.clear();
+    }
+
+    bool restore(const std::vector<double> &state)
+    {
+        return state.empty();
+    }
+
+    inline bool accept(double current_cost, double neighbor_cost, double prob_kt, Random &)
+    {
+        return neighbor_cost <= current_cost || neighbor_cost - current_cost < prob_kt;
+    }
+};
+
+// Accepts neighbors no worse than the current cost some evaluations ago
+// (Late Acceptance Hill Climbing)
+struct LateAcceptance
+{
+    static constexpr const char *NAME = "late";
+
+    // Current costs of the last evaluations, circular
+    std::vector<double> history;
+    unsigned int position;
+    bool filled;
+
+    LateAcceptance(const PolicyParameters &parameters) : history(std::max(parameters.history_length, 1u))
+    {
+        this->position = 0;
+        this->filled = false;
+    }
+
+    inline bool accept(double current_cost, double neighbor_cost, double, Random &)
+    {
+        // The history starts with the first current cost
+        if (!this->filled)
+        {
+            std::fill(this->history.begin(), this->history.end(), current_cost);
+            this->filled = true;
+        }
+
+        double &late_cost = this->history[this->position];
+        this->position = this->position + 1 < this->history.size() ? this->position + 1 : 0;
+
+        bool accepted = neighbor_cost <= current_cost || neighbor_cost <= late_cost;
+        late_cost = accepted ? neighbor_cost : current_cost;
+
+        return accepted;
+    }
+
+    // Position, whether the history is filled, then the history
+    void save(std::vector<double> &state) const
+    {
+        state.assign(1, this->position);
+        state.push_back(this->filled);
+        state.insert(state.end(), this->history.begin(), this->history.end());
+    }
+
+    bool restore(const std::vector<double> &state)
+    {
+        if (state.size() != this->history.size() + 2 || state[0] < 0 || state[0] >= this->history.size())
+            return false;
+
+        this->position = state[0];
+        this->filled = state[1] != 0;
+        std::copy(state.begin() + 2, state.end(), this->history.begin());
+
+        return true;
+    }
+};
+
+// COOLING SCHEDULES, the temperature after a temperature step. Schedules
+// with calibration samples get the cost increases of that many random
+// neighbors of the starting state, and choose the initial temperature
+
+// t = t * r
+struct GeometricCooling
+{
+    static constexpr const char *NAME = "geometric";
+    static constexpr unsigned int CALIBRATION_SAMPLES = 0;
+
+    double cooling_factor;
+
+    GeometricCooling(const PolicyParameters &parameters)
+    {
+        this->cooling_factor = parameters.cooling_factor;
+    }
+
+    void save(std::vector<double> &state) const
+    {
+        state.clear();
+    }
+
+    bool restore(const std::vector<double> &state)
+    {
+        return state.empty();
+    }
+
+    double calibrate(double temperature, const std::vector<double> &)
+    {
+        return temperature;
+    }
+
+    inline double cool(double temperature, const StepFeedback &)
+    {
+        return temperature * this->cooling_factor;
+    }
+};
+
+// Falls by the same amount every step, reaching 0 at the last iteration
+struct LinearCooling
+{
+    static constexpr const char *NAME = "linear";
+    static constexpr unsigned int CALIBRATION_SAMPLES = 0;
+
+    double initial_temperature;
+    unsigned long max_iterations;
+
+    LinearCooling(const PolicyParameters &parameters)
+    {
+        this->initial_temperature = parameters.temperature;
+        this->max_iterations = std::max(parameters.max_iterations, 1ul);
+    }
+
+    void save(std::vector<double> &state) const
+    {
+        state.clear();
+    }
+
+    bool restore(const std::vector<double> &state)
+    {
+        return state.empty();
+    }
+
+    double calibrate(double temperature, const std::vector<double> &)
+    {
+        return temperature;
+    }
+
+    inline double cool(double, const StepFeedback &step)
+    {
+        return this->initial_temperature * (1 - (double)step.iteration_number / this->max_iterations);
+    }
+};
+
+// t = t / (1 + b * t), with b chosen so that the first step matches the
+// geometric schedule with the same cooling factor (Lundy and Mees)
+struct LundyMeesCooling
+{
+    static constexpr const char *NAME = "lundy-mees";
+    static constexpr unsigned int CALIBRATION_SAMPLES = 0;
+
+    double beta;
+
+    LundyMeesCooling(const PolicyParameters &parameters)
+    {
+        this->beta = (1 - parameters.cooling_factor) / (parameters.cooling_factor * parameters.temperature);
+    }
+
+    void save(std::vector<double> &state) const
+    {
+        state.clear();
+    }
+
+    bool restore(const std::vector<double> &state)
+    {
+        return state.empty();
+    }
+
+    double calibrate(double temperature, const std::vector<double> &)
+    {
+        return temperature;
+    }
+
+    inline double cool(double temperature, const StepFeedback &)
+    {
+        return temperature / (1 + this->beta * temperature);
+    }
+};
+
+// Chooses the initial temperature so that worse neighbors are accepted with
+// the given ratio, then steers the measured ratio of accepted worse neighbors
+// towards a target that is multiplied by r every step: the temperature is
+// multiplied by r when the ratio is above the target, divided by r when
+// below. When the best state stagnates once the search is frozen (less than
+// 1% of worse neighbors accepted), it reheats to twice the temperature of
+// the last improvement, and after the given number of fruitless reheats it
+// drops the temperature to 0, which ends the run.
+struct AdaptiveCooling
+{
+    static constexpr const char *NAME = "adaptive";
+    static constexpr unsigned int CALIBRATION_SAMPLES = 200;
+    static constexpr double FROZEN_ACCEPTANCE = 0.01;
+
+    double constant;
+    double cooling_factor;
+    double initial_acceptance;
+    unsigned int stagnation_steps;
+    unsigned int max_reheats;
+
+    // Mean cost increase of worse neighbors
+    double mean_increase;
+
+    // Smoothed and target acceptance ratios of worse neighbors
+    double acceptance_ratio;
+    double target_ratio;
+
+    // Initial temperature, temperature and iteration of the last improvement,
+    // and reheats since then
+    double initial_temperature;
+    double improvement_temperature;
+    unsigned long improvement_iteration;
+    unsigned int reheats;
+
+    AdaptiveCooling(const PolicyParameters &parameters)
+    {
+        this->constant = parameters.constant;
+        this->cooling_factor = parameters.cooling_factor;
+        this->initial_acceptance = std::min(std::max(parameters.initial_acceptance, 0.01), 0.99);
+        this->stagnation_steps = std::max(parameters.stagnation_steps, 1u);
+        this->max_reheats = parameters.max_reheats;
+
+        this->mean_increase = 1;
+        this->acceptance_ratio = this->initial_acceptance;
+        this->target_ratio = this->initial_acceptance;
+
+        this->initial_temperature = parameters.temperature;
+        this->improvement_temperature = parameters.temperature;
+        this->improvement_iteration = 0;
+        this->reheats = 0;
+    }
+
+    /**
+     * @brief Expected acceptance ratio of worse neighbors at a temperature
+     */
+    inline double expectedRatio(double temperature)
+    {
+        return std::exp(-this->mean_increase / (this->constant * temperature));
+    }
+
+    void save(std::vector<double> &state) const
+    {
+        state.assign({this->mean_increase, this->acceptance_ratio, this->target_ratio, this->initial_temperature,
+                      this->improvement_temperature, (double)this->improvement_iteration, (double)this->reheats});
+    }
+
+    bool restore(const std::vector<double> &state)
+    {
+        if (state.size() != 7)
+            return false;
+
+        this->mean_increase = state[0];
+        this->acceptance_ratio = state[1];
+        this->target_ratio = state[2];
+        this->initial_temperature = state[3];
+        this->improvement_temperature = state[4];
+        this->improvement_iteration = state[5];
+        this->reheats = state[6];
+
+        return true;
+    }
+
+    double calibrate(double temperature, const std::vector<double> &increases)
+    {
+        if (!increases.empty())
+        {
+            // e ^ -mean / k * t0 = initial acceptance
+            this->mean_increase = 0;
+            for (auto i = increases.begin(); i != increases.end(); ++i)
+                this->mean_increase += *i;
+            this->mean_increase /= increases.size();
+
+            temperature = -this->mean_increase / (this->constant * std::log(this->initial_acceptance));
+        }
+
+        this->initial_temperature = temperature;
+        this->improvement_temperature = temperature;
+
+        return temperature;
+    }
+
+    inline double cool(double temperature, const StepFeedback &step)
+    {
+        if (step.uphill_evaluated > 0)
+            this->acceptance_ratio = 0.9 * this->acceptance_ratio + 0.1 * step.uphill_accepted / step.uphill_evaluated;
+
+        this->target_ratio *= this->cooling_factor;
+
+        // Only stagnation of a frozen search counts
+        if (this->acceptance_ratio >= FROZEN_ACCEPTANCE || this->target_ratio >= FROZEN_ACCEPTANCE)
+            this->improvement_iteration = step.iteration_number;
+
+        if (step.improved)
+        {
+            this->improvement_temperature = temperature;
+            this->improvement_iteration = step.iteration_number;
+            this->reheats = 0;
+        }
+        else if (step.iteration_number - this->improvement_iteration >= this->stagnation_steps)
+        {
+            if (this->reheats >= this->max_reheats)
+                return 0;
+
+            this->improvement_iteration = step.iteration_number;
+            this->reheats++;
+
+            temperature = std::min(std::max(temperature, 2 * this->improvement_temperature), this->initial_temperature);
+            this->target_ratio = this->expectedRatio(temperature);
+            this->acceptance_ratio = this->target_ratio;
+
+            return temperature;
+        }
+
+        return this->acceptance_ratio > this->target_ratio ? temperature * this->cooling_factor : temperature / this->cooling_factor;
+    }
+};
+
+#endif // ANNEALING_POLICIES_H
@@ -0,0 +1,101 @@
+/**
+ * Batch mode: solves many instances in one process, on a thread pool,
+ * streaming one JSON record per instance to a JSONL file.
+ */
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Solver.h"
+#include "SolutionCache.h"
+#include "ThreadPool.h"
+
+class Batch
+{
+private:
+    // Instances to solve, in input order
+    std::vector<std::string> files;
+
+    // Parameters shared by every instance, each one gets its own stream
+    SolverParameters parameters;
+
+    // Number of worker threads (0 uses every core)
+    unsigned int thread_count;
+
+    // Best known colorings, when enabled, and the target number of colors
+    SolutionCache *cache;
+    unsigned int target;
+
+    // Results file, shared by the workers
+    std::ofstream output;
+    std::mutex output_lock;
+
+    /**
+     * @brief Loads and solves one instance, writing its record
+     * @param index Index of the instance in input order, used as its random stream
+     */
+    bool solve(unsigned int index);
+
+    /**
+     * @brief Writes one line to the results file 
+     */
+    void write(std::string record);
+
+public:
+    /**
+     * @brief Batch constructor
+     * @param solver_parameters Algorithm parameters
+     * @param threads Number of worker threads (0 uses every core)
+     */
+    Batch(SolverParameters solver_parameters, unsigned int threads = 0);
+
+    /**
+     * @brief Batch destructor 
+     */
+    ~Batch();
+
+    /**
+     * @brief Adds a single instance file 
+     */
+    void addFile(std::string filename);
+
+    /**
+     * @brief Adds every instance listed by a path: every graph file (see
+     * GraphReader::isGraphFile(), compressed or not) when it is a directory,
+     * the file itself when it is a graph file, otherwise one file per line
+     * of the manifest (blank lines and lines starting with '#' are ignored,
+     * relative paths are relative to the manifest)
+     */
+    void addInstances(std::string path);
+
+    /**
+     * @brief Returns the instances listed by a path, see addInstances()
+     */
+    static std::vector<std::string> listInstances(std::string path);
+
+    /**
+     * @brief Warm-starts every instance from its best known coloring and
+     * stores better ones, instances already solved are not searched again
+     * @param directory Solution cache directory
+     * @param target_colors Colorings with at most this many colors are solved (0 for none)
+     */
+    void setCache(std::string directory, unsigned int target_colors);
+
+    /**
+     * @brief Returns the number of instances added 
+     */
+    unsigned int getInstanceCount();
+
+    /**
+     * @brief Solves every instance, largest files first
+     * @param output_filename JSONL results file
+     * @returns Number of instances that failed
+     */
+    unsigned int run(std::string output_filename);
+};
+
+#endif // BATCH_H
@@ -0,0 +1,110 @@
+/**
+ * Exact coloring by DSATUR branch and bound: vertexes are colored in order
+ * of saturation (distinct colors among their neighbors), trying every
+ * color their neighbors leave free and one new color, and branches that
+ * cannot beat the best coloring are cut. Meant for graphs of a few hundred
+ * vertexes, reduced graphs and components; larger ones stop at the time
+ * limit with the best coloring found.
+ */
+#ifndef BRANCH_AND_BOUND_H
+#define BRANCH_AND_BOUND_H
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "Graph.h"
+#include "Snapshot.h"
+
+class BranchAndBound
+{
+private:
+    // Adjacency in compressed rows
+    unsigned int vertex_count;
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> targets;
+
+    // Colors of the search, -1 while uncolored
+    std::vector<unsigned int> colors;
+
+    // Neighbors of each vertex with each color (count_stride colors per
+    // vertex), and the saturation set as a bitset of the colors with any,
+    // words_per_vertex words per vertex
+    std::vector<unsigned int> neighbor_counts;
+    std::vector<uint64_t> saturation;
+    std::vector<unsigned int> saturation_degree;
+    unsigned int count_stride;
+    unsigned int words_per_vertex;
+
+    // Colors available, one less than the best coloring
+    unsigned int color_limit;
+
+    // Best coloring found and its number of colors
+    std::vector<unsigned int> best;
+    unsigned int best_count;
+
+    // Clique lower bound
+    unsigned int lower_bound;
+
+    // Search limits and statistics
+    std::chrono::steady_clock::time_point deadline;
+    unsigned long nodes;
+
+    /**
+     * @brief Gives a color to a vertex, updating its neighbors' saturation
+     */
+    void assign(unsigned int vertex, unsigned int color);
+
+    /**
+     * @brief Removes the color of a vertex, undoing assign()
+     */
+    void unassign(unsigned int vertex);
+
+    /**
+     * @brief Returns the most saturated uncolored vertex, ties by degree
+     */
+    unsigned int select();
+
+    /**
+     * @brief Searches the whole tree, with an explicit stack since the
+     * depth is the number of vertexes
+     * @returns False if the time ran out
+     */
+    bool search();
+
+public:
+    /**
+     * @brief Prepares the search of a graph
+     * @param graph The graph
+     */
+    BranchAndBound(Graph &graph);
+
+    /**
+     * @brief Branch and bound destructor
+     */
+    ~BranchAndBound();
+
+    /**
+     * @brief Searches for a coloring with fewer colors than the given one
+     * @param coloring Valid coloring used as the upper bound, replaced by the
+     * best one found
+     * @param seconds Time limit
+     * @returns If the resulting coloring is proven optimal
+     */
+    bool solve(Snapshot &coloring, double seconds);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the clique lower bound
+     */
+    unsigned int getLowerBound();
+
+    /**
+     * @brief Returns the number of search nodes of the last solve
+     */
+    unsigned long getNodes();
+};
+
+#endif // BRANCH_AND_BOUND_H
@@ -0,0 +1,113 @@
+/**
+ * Checkpoints of a Simulated Annealing run: the current and best colorings,
+ * temperature, iteration number, generator state and the state of the
+ * acceptance rule and cooling schedule, saved to a compact binary file so
+ * that a run can be resumed after it is interrupted.
+ */
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Snapshot.h"
+
+struct Checkpoint
+{
+    // Size and canonical hash of the colored graph, checked when resuming
+    unsigned int vertex_count;
+    unsigned int edge_count;
+    uint64_t graph_hash;
+
+    // Position of the run
+    unsigned long iteration_number;
+    double temperature;
+    double elapsed_seconds;
+
+    // Generator state
+    uint64_t rng_state[4];
+
+    // Internal state of the acceptance rule and the cooling schedule
+    std::vector<double> acceptance_state;
+    std::vector<double> schedule_state;
+
+    // Current and best colorings
+    Snapshot current;
+    Snapshot best;
+
+    /**
+     * @brief Writes the checkpoint to a temporary file and renames it over
+     * the given one, so that a crash never leaves a partial checkpoint
+     * @param filename Checkpoint file
+     */
+    void write(std::string filename);
+
+    /**
+     * @brief Reads a checkpoint file, rejecting damaged ones: colorings of
+     * another size or with colors outside 0 through vertex_count - 1
+     * @param filename Checkpoint file
+     */
+    void read(std::string filename);
+};
+
+/**
+ * Writes checkpoints on a background thread, so that the run only pays
+ * for copying its colorings into the checkpoint
+ */
+class CheckpointWriter
+{
+private:
+    // Checkpoint file
+    std::string filename;
+
+    // Checkpoint being filled by the run and checkpoint being written
+    Checkpoint staged;
+    Checkpoint writing;
+
+    // Synchronization with the writing thread
+    std::thread writer;
+    std::mutex lock;
+    std::condition_variable changed;
+    bool pending;
+    bool stopping;
+
+    /**
+     * @brief Writing thread loop 
+     */
+    void work();
+
+public:
+    /**
+     * @brief Starts the writing thread
+     * @param filename Checkpoint file
+     * @param vertexes Number of vertexes, used to reserve the colorings
+     */
+    CheckpointWriter(std::string filename, unsigned int vertexes);
+
+    /**
+     * @brief Writes the last submitted checkpoint and stops the thread 
+     */
+    ~CheckpointWriter();
+
+    /**
+     * @brief Returns the checkpoint to be filled, or NULL while the
+     * previous one has not been picked up by the writing thread
+     */
+    Checkpoint *stage();
+
+    /**
+     * @brief Hands the staged checkpoint to the writing thread 
+     */
+    void submit();
+};
+
+#endif // CHECKPOINT_H
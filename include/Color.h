@@ -3,29 +3,33 @@
 
 #include <vector>
 
-#include "Vertex.h"
+#include "Index.h"
 
-class Vertex;
-
-class Color
+template <typename Index>
+class BasicColor
 {
 private:
     // Unique identifier given to this color
-    unsigned int id;
+    Index id;
+
+    // Number of vertexes that use this color
+    Index usage_counter;
 
-    // Set of vertexes that use this color
-    std::vector<unsigned int> used_by;
+    // First and last vertexes of the list of users, linked through
+    // the vertexes themselves so that copying a color never allocates
+    Index first_user;
+    Index last_user;
 
 public:
     /**
      * @brief Color constructor 
      */
-    Color(unsigned int color_id = 0);
+    BasicColor(unsigned int color_id = 0);
 
     /**
      * @brief Color destructor 
      */
-    ~Color();
+    ~BasicColor();
 
     // GETTERS
 
@@ -35,9 +39,16 @@ public:
     unsigned int getId();
 
     /**
-     * @brief Returns this color's list of users 
+     * @brief Returns the first vertex in this color's list of users,
+     * or -1 if the color is unused
+     */
+    unsigned int getFirstUser();
+
+    /**
+     * @brief Returns the last vertex in this color's list of users,
+     * or -1 if the color is unused
      */
-    std::vector<unsigned int> getUsers();
+    unsigned int getLastUser();
 
     /**
      * @brief Returns the amount of vertexes that
@@ -54,14 +65,27 @@ public:
     void setId(unsigned int color_id);
 
     /**
-     * @brief Adds a new vertex as using this color
+     * @brief Adds a new vertex at the end of the list of users
+     * @param vertex_id The new user
      */
     void addUser(unsigned int vertex_id);
 
     /**
      * @brief Removes a vertex as using this color
+     * @param vertex_id The removed user
+     * @param previous_user The user before it in the list (or -1)
+     * @param next_user The user after it in the list (or -1)
      */
-    void removeUser(unsigned int vertex);
+    void removeUser(unsigned int vertex_id, unsigned int previous_user, unsigned int next_user);
+
+    /**
+     * @brief Takes over the list of users of another color, which is left unused
+     * @param color The color whose users are taken
+     */
+    void takeUsers(BasicColor &color);
 };
 
+// Color with 32 bit ids, used outside of the search
+typedef BasicColor<uint32_t> Color;
+
 #endif // COLOR_H
@@ -0,0 +1,79 @@
+/**
+ * Splits a graph into its connected components, found with union-find,
+ * each relabeled into a compact subgraph that can be colored on its own.
+ */
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include <vector>
+
+#include "Graph.h"
+
+// Components whose optimal coloring is known without searching
+enum ComponentKind
+{
+    COMPONENT_GENERAL,
+    COMPONENT_BIPARTITE, // Includes isolated vertexes and trees
+    COMPONENT_CLIQUE
+};
+
+class Decomposition
+{
+private:
+    // Original ids of the vertexes of each component
+    std::vector<std::vector<unsigned int>> vertexes;
+
+    // Number of distinct edges of each component
+    std::vector<unsigned long> edge_counts;
+
+    // Compact subgraph of each component
+    std::vector<Graph *> components;
+
+    /**
+     * @brief Finds the root of a vertex, halving the path on the way
+     */
+    static unsigned int find(std::vector<unsigned int> &parent, unsigned int vertex);
+
+public:
+    /**
+     * @brief Finds the connected components of a graph
+     * @param graph The graph
+     */
+    Decomposition(Graph &graph);
+
+    /**
+     * @brief Decomposition destructor 
+     */
+    ~Decomposition();
+
+    /**
+     * @brief Returns the number of components 
+     */
+    unsigned int getComponentCount();
+
+    /**
+     * @brief Returns a component, vertexes numbered 0 through its size - 1
+     * @param component_id The component, largest first
+     */
+    Graph &getComponent(unsigned int component_id);
+
+    /**
+     * @brief Returns the original ids of a component's vertexes 
+     */
+    const std::vector<unsigned int> &getVertexes(unsigned int component_id);
+
+    /**
+     * @brief Returns the number of distinct edges of a component 
+     */
+    unsigned long getEdgeCount(unsigned int component_id);
+
+    /**
+     * @brief Classifies a component and, for cliques and bipartite
+     * components, computes their optimal coloring
+     * @param component_id The component
+     * @param coloring Receives the optimal coloring, when one is known
+     */
+    ComponentKind classify(unsigned int component_id, std::vector<unsigned int> &coloring);
+};
+
+#endif // DECOMPOSITION_H
@@ -0,0 +1,217 @@
+/**
+ * Keeps a coloring valid while edges are inserted and removed. A conflict
+ * created by an insertion is repaired locally: the endpoint takes a color
+ * its neighbors leave free, or one freed by a bounded Kempe chain swap, or
+ * a new color. When the number of colors drifts above the best known, a
+ * background solve of a copy of the graph looks for a better coloring,
+ * which replaces the current one once the updates since the copy are
+ * repaired on it.
+ */
+#ifndef DYNAMIC_COLORING_H
+#define DYNAMIC_COLORING_H
+
+#include <atomic>
+#include <istream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Graph.h"
+#include "Solver.h"
+
+// An edge insertion or removal, vertexes numbered 0 through N-1
+struct EdgeUpdate
+{
+    bool insert;
+    unsigned int first;
+    unsigned int second;
+};
+
+// Counters of a dynamic coloring
+struct DynamicStatistics
+{
+    unsigned long insertions = 0;
+    unsigned long removals = 0;
+
+    // Insertions between vertexes with the same color, and how they were repaired
+    unsigned long conflicts = 0;
+    unsigned long free_color_repairs = 0;
+    unsigned long kempe_repairs = 0;
+    unsigned long new_color_repairs = 0;
+
+    // Colors emptied after removals
+    unsigned long removal_improvements = 0;
+
+    // Background solves, and the ones that lowered the number of colors
+    unsigned long background_passes = 0;
+    unsigned long background_improvements = 0;
+};
+
+class DynamicColoring
+{
+private:
+    // Longest Kempe chain swapped, and (color, color) pairs tried per repair
+    static const unsigned int MAX_CHAIN = 64;
+    static const unsigned int MAX_KEMPE_TRIES = 16;
+
+    // Current graph, its coloring is kept below
+    Graph G;
+
+    // Parameters of the initial and background solves
+    SolverParameters parameters;
+
+    // Color of each vertex, the vertexes of each color and each vertex's
+    // position in its color, colors are numbered 0 through k - 1
+    std::vector<unsigned int> colors;
+    std::vector<std::vector<unsigned int>> classes;
+    std::vector<unsigned int> positions;
+
+    // Scratch: colors marked with the current stamp are forbidden, neighbor
+    // count per color, and the neighbors of the repaired vertex and the
+    // vertexes of the current Kempe chain, marked with their own stamps
+    std::vector<unsigned int> color_marks;
+    std::vector<unsigned int> color_counts;
+    unsigned int mark_stamp;
+    std::vector<unsigned int> neighbor_marks;
+    std::vector<unsigned int> visit_marks;
+    unsigned int visit_stamp;
+    std::vector<unsigned int> chain;
+
+    // Number of colors of the last solve
+    unsigned int best_known;
+
+    // Background solve: its thread, graph copy and result, and the edges
+    // inserted since the copy, repaired again when the result is taken
+    std::thread worker;
+    bool worker_running;
+    std::atomic<bool> worker_done;
+    Graph *worker_graph;
+    Snapshot worker_coloring;
+    SolverResult worker_result;
+    std::vector<std::pair<unsigned int, unsigned int>> inserted_since;
+
+    DynamicStatistics statistics;
+
+    /**
+     * @brief Moves a vertex to another color, or to a new one (k), without
+     * renumbering a color it empties, see compact()
+     */
+    void move(unsigned int vertex, unsigned int color);
+
+    /**
+     * @brief Renumbers the highest color to an emptied one, keeping the
+     * colors numbered 0 through k - 1
+     */
+    void compact(unsigned int color);
+
+    /**
+     * @brief Marks the colors of a vertex's neighbors with a new stamp, and
+     * counts them per color
+     * @returns The lowest color not marked, other than the vertex's own (k if none)
+     */
+    unsigned int markNeighbors(unsigned int vertex);
+
+    /**
+     * @brief Frees a color for a vertex by swapping a Kempe chain: the
+     * vertexes colored a or b connected to its a-colored neighbors, which
+     * must not include a b-colored neighbor
+     * @returns The freed color, or -1 if no chain up to MAX_CHAIN vertexes works
+     */
+    unsigned int kempe(unsigned int vertex);
+
+    /**
+     * @brief Recolors a vertex that conflicts with a neighbor
+     */
+    void repair(unsigned int vertex);
+
+    /**
+     * @brief Replaces the whole coloring
+     */
+    void setColoring(const std::vector<unsigned int> &coloring);
+
+    /**
+     * @brief Waits for the background solve and takes its result if it is
+     * still better once the edges inserted meanwhile are repaired
+     */
+    void collect();
+
+    /**
+     * @brief Takes the result of a finished background solve, and starts one
+     * if the number of colors is above the best known
+     */
+    void poll();
+
+public:
+    /**
+     * @brief Colors a graph with the solver, then keeps it colored
+     * @param graph The initial graph, copied
+     * @param solver_parameters Parameters of the initial and background solves
+     */
+    DynamicColoring(Graph &graph, SolverParameters solver_parameters);
+
+    /**
+     * @brief Waits for a running background solve
+     */
+    ~DynamicColoring();
+
+    /**
+     * @brief Adds an edge, repairing the coloring if its endpoints share a color
+     * @param first First vertex (numbered 0 through N-1)
+     * @param second Second vertex (numbered 0 through N-1)
+     */
+    void insertEdge(unsigned int first, unsigned int second);
+
+    /**
+     * @brief Removes an edge, emptying a color if an endpoint was alone in its own
+     * @param first First vertex (numbered 0 through N-1)
+     * @param second Second vertex (numbered 0 through N-1)
+     */
+    void removeEdge(unsigned int first, unsigned int second);
+
+    /**
+     * @brief Applies an update
+     */
+    void apply(const EdgeUpdate &update);
+
+    /**
+     * @brief Waits for a running background solve and takes its result
+     */
+    void finish();
+
+    /**
+     * @brief Reads the next update of a stream. Text streams have one update
+     * per line, "+ u v" (or "e u v") to insert and "- u v" to remove, with
+     * vertexes numbered 1 through N like DIMACS files, and "c" comments.
+     * Binary streams have three little endian 32 bit values per update:
+     * 1 to insert or 0 to remove, then the vertexes numbered 1 through N
+     * @param stream The stream
+     * @param binary If the stream is binary
+     * @param update Receives the update
+     * @returns False at the end of the stream
+     */
+    static bool readUpdate(std::istream &stream, bool binary, EdgeUpdate &update);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the number of colors
+     */
+    unsigned int getColorCount();
+
+    /**
+     * @brief Returns the current coloring, one color per vertex
+     */
+    const std::vector<unsigned int> &getColoring();
+
+    /**
+     * @brief Returns the current graph, uncolored
+     */
+    Graph &getGraph();
+
+    /**
+     * @brief Returns the counters
+     */
+    DynamicStatistics getStatistics();
+};
+
+#endif // DYNAMIC_COLORING_H
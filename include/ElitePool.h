@@ -0,0 +1,65 @@
+/**
+ * Fixed size pool with the best distinct colorings found, kept as
+ * compact snapshots so that they can be used for restarts.
+ */
+#ifndef ELITE_POOL_H
+#define ELITE_POOL_H
+
+#include <vector>
+
+#include "Graph.h"
+#include "Snapshot.h"
+
+class ElitePool
+{
+private:
+    // Stored snapshots, the first 'size' ones sorted by value
+    std::vector<Snapshot> elite;
+
+    // Number of snapshots in use
+    unsigned int size;
+
+    // Candidate buffer, swapped into the pool when accepted
+    Snapshot candidate;
+
+public:
+    /**
+     * @brief Elite pool constructor 
+     * @param capacity Maximum number of snapshots kept
+     * @param vertex_count Number of vertexes of the stored colorings
+     */
+    ElitePool(unsigned int capacity, unsigned int vertex_count);
+
+    /**
+     * @brief Elite pool destructor 
+     */
+    ~ElitePool();
+
+    /**
+     * @brief Checks if a coloring with the given value would enter the pool
+     * @param value Coloring value
+     */
+    bool accepts(unsigned int value);
+
+    /**
+     * @brief Offers a coloring to the pool, it is stored if it is better than the
+     * worst stored coloring and not already in the pool
+     * @param graph The colored graph
+     * @param value Coloring value
+     * @returns If the coloring was stored
+     */
+    template <typename Index>
+    bool offer(BasicGraph<Index> &graph, unsigned int value);
+
+    /**
+     * @brief Returns the number of stored snapshots 
+     */
+    unsigned int getSize();
+
+    /**
+     * @brief Returns the i-th best stored snapshot
+     */
+    Snapshot *get(unsigned int i);
+};
+
+#endif // ELITE_POOL_H
@@ -0,0 +1,142 @@
+/**
+ * Hybrid evolutionary search: a population of colorings, kept as compact
+ * snapshots, produces offspring with Greedy Partition Crossover (GPX) on
+ * their color classes. Every offspring is improved with a short Simulated
+ * Annealing run, and the population keeps the members that are both good
+ * and far apart in partition distance.
+ */
+#ifndef EVOLUTION_H
+#define EVOLUTION_H
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#include "Graph.h"
+#include "Random.h"
+#include "SimulatedAnnealing.h"
+#include "Snapshot.h"
+#include "ThreadPool.h"
+
+class Evolution
+{
+public:
+    // Creates the improvement run of an offspring, with its own generator
+    typedef std::function<SimulatedAnnealing *(Random)> Kernel;
+
+private:
+    // Weight of the value against the distance when choosing the member to drop
+    static constexpr double VALUE_WEIGHT = 0.6;
+
+    // The uncolored graph
+    Graph &G;
+
+    // Generator of the parent choices and the offspring seeds
+    Random rng;
+
+    // Improvement runs
+    Kernel kernel;
+
+    // Offspring produced at once, one per thread
+    unsigned int threads;
+
+    // Members, and the partition distance between every two of them
+    std::vector<Snapshot> population;
+    std::vector<std::vector<unsigned int>> distances;
+
+    // Best member
+    Snapshot best;
+
+    // Iterations of every improvement run
+    unsigned long iterations;
+
+    // Start of the search, and iterations and time when the best member was added
+    std::chrono::steady_clock::time_point start;
+    unsigned long best_iteration;
+    double best_seconds;
+
+    /**
+     * @brief Improves a coloring with a run of the kernel
+     * @param coloring The coloring, replaced by the best one found
+     * @param random Generator of the run
+     * @returns Iterations of the run
+     */
+    unsigned long improve(Snapshot &coloring, Random random);
+
+    /**
+     * @brief Adds a coloring to the population, then drops the member with
+     * the worst combination of value and distance to the others, if the
+     * population is over its size. The best member is never dropped
+     * @param coloring The coloring, moved into the population
+     * @param size Population size
+     */
+    void insert(Snapshot &coloring, unsigned int size);
+
+public:
+    /**
+     * @brief Evolution constructor
+     * @param graph The uncolored graph
+     * @param random Generator of the search
+     * @param kernel Creates the improvement runs, each run is set to the
+     * coloring it improves and run to the end
+     * @param threads Offspring improved concurrently (0 uses every core)
+     */
+    Evolution(Graph &graph, Random random, Kernel kernel, unsigned int threads = 0);
+
+    /**
+     * @brief Evolution destructor
+     */
+    ~Evolution();
+
+    /**
+     * @brief Builds the population and evolves it
+     * @param size Population size, at least 2
+     * @param generations Rounds of offspring
+     * @param initial_coloring Valid coloring added to the population (optional)
+     */
+    void run(unsigned int size, unsigned int generations, Snapshot *initial_coloring = NULL);
+
+    /**
+     * @brief Greedy Partition Crossover: the offspring takes the largest
+     * class of each parent in turn, without the vertexes already taken, for
+     * one class less than the best parent uses. The remaining vertexes get
+     * the first color their neighbors leave free
+     * @param graph The graph both parents color
+     * @param first First parent
+     * @param second Second parent
+     * @param offspring Receives the offspring coloring
+     * @param random Generator for the order of the remaining vertexes
+     */
+    static void crossover(Graph &graph, Snapshot &first, Snapshot &second, Snapshot &offspring, Random &random);
+
+    /**
+     * @brief Partition distance: the number of vertexes that must change
+     * color to turn one coloring into the other, with the classes matched
+     * greedily by their overlap
+     */
+    static unsigned int distance(Snapshot &first, Snapshot &second);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the best coloring found
+     */
+    Snapshot *getBest();
+
+    /**
+     * @brief Returns the iterations of every improvement run
+     */
+    unsigned long getIterations();
+
+    /**
+     * @brief Returns the iterations run when the best coloring was added
+     */
+    unsigned long getBestIteration();
+
+    /**
+     * @brief Returns the seconds elapsed when the best coloring was added
+     */
+    double getBestSeconds();
+};
+
+#endif // EVOLUTION_H
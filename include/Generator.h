@@ -0,0 +1,135 @@
+/**
+ * Synthetic graphs for scaling benchmarks: uniform random, queen, flat and
+ * Leighton graphs with a hidden k-coloring, and power-law (Chung-Lu)
+ * graphs. Every generator is deterministic for a given seed and runs in
+ * time proportional to the vertexes plus the edges, so graphs of millions
+ * of vertexes are generated in seconds. The graph is built in memory or
+ * written as a DIMACS file.
+ */
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Graph.h"
+#include "Random.h"
+
+class Generator
+{
+private:
+    // Generator of the edges
+    Random rng;
+
+    // Vertexes, and the edges as pairs of vertexes (first < second)
+    unsigned int vertex_count;
+    std::vector<unsigned int> edges;
+
+    /**
+     * @brief Adds an edge, loops are dropped
+     */
+    void addEdge(unsigned int first, unsigned int second);
+
+    /**
+     * @brief Sorts the edges and drops the duplicates
+     */
+    void normalize();
+
+    /**
+     * @brief Returns the number of failures before the next success of
+     * independent trials with probability p (geometric distribution)
+     */
+    unsigned long skip(double p);
+
+    /**
+     * @brief Splits the vertexes in k classes of equal size (up to one), in
+     * random order, the hidden coloring of flat and Leighton graphs
+     */
+    void partition(unsigned int k, std::vector<std::vector<unsigned int>> &classes);
+
+public:
+    /**
+     * @brief Generator constructor
+     * @param seed Seed of the generated graphs
+     */
+    Generator(uint64_t seed = 1);
+
+    /**
+     * @brief Generator destructor
+     */
+    ~Generator();
+
+    /**
+     * @brief Erdos-Renyi G(n, p): every edge with probability p
+     */
+    void random(unsigned int n, double p);
+
+    /**
+     * @brief Queen graph of an n by n board: squares attacking each other
+     * along rows, columns and diagonals are adjacent
+     */
+    void queen(unsigned int n);
+
+    /**
+     * @brief Flat graph: the vertexes are split in k hidden classes, and
+     * every two classes get the same share p of the edges between them
+     */
+    void flat(unsigned int n, unsigned int k, double p);
+
+    /**
+     * @brief Leighton graph: the vertexes are split in k hidden classes, and
+     * cliques over distinct classes are added, one of k vertexes and then of
+     * random sizes between 2 and k, until there are m edges. The chromatic
+     * number is k
+     */
+    void leighton(unsigned int n, unsigned int k, unsigned long m);
+
+    /**
+     * @brief Chung-Lu graph: vertex i has expected degree proportional to
+     * (i + 1)^(-1 / (exponent - 1)), a power law degree distribution with
+     * the given exponent and average degree
+     */
+    void chungLu(unsigned int n, double average_degree, double exponent);
+
+    /**
+     * @brief Generates a graph from a specification: gnp:<n>:<p>,
+     * queen:<n>, flat:<n>:<k>:<p>, leighton:<n>:<k>:<m> or
+     * chung-lu:<n>:<average-degree>:<exponent>
+     */
+    void generate(std::string specification);
+
+    /**
+     * @brief Builds the generated graph
+     * @returns The graph, owned by the caller
+     */
+    Graph *build();
+
+    /**
+     * @brief Writes the generated graph as a DIMACS text file
+     */
+    void writeDimacs(std::string filename);
+
+    /**
+     * @brief Writes the generated graph as a DIMACS binary file (.col.b),
+     * a bit matrix of n^2 / 16 bytes, for graphs of up to some ten
+     * thousand vertexes
+     */
+    void writeBinary(std::string filename);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the number of vertexes of the generated graph
+     */
+    unsigned int getVertexCount();
+
+    /**
+     * @brief Returns the number of edges of the generated graph
+     */
+    unsigned long getEdgeCount();
+};
+
+#endif // GENERATOR_H
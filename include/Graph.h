@@ -7,16 +7,22 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
 #include "Color.h"
 #include "Vertex.h"
 #include "Edge.h"
+#include "GraphReader.h"
+#include "Index.h"
 
-class Graph
+template <typename Index>
+class BasicGraph
 {
 private:
     // Information
@@ -25,13 +31,25 @@ private:
     unsigned int used_colors_counter;
 
     // Vertex set V
-    std::vector<Vertex> V;
+    std::vector<BasicVertex<Index>> V;
 
     // Edge set E
     std::vector<Edge> E;
 
-    // Color set C
-    std::vector<Color> C;
+    // Color set C, only the used colors: they are always numbered 0 through k - 1
+    std::vector<BasicColor<Index>> C;
+
+    /**
+     * @brief Sizes the vertex and color sets
+     * @param vertexes Number of vertexes
+     * @param edges Number of edges
+     */
+    void initialize(unsigned int vertexes, unsigned int edges);
+
+    /**
+     * @brief Sizes the graph and adds the edges of a symmetric CSR adjacency structure
+     */
+    void initializeRows(unsigned int vertexes, const unsigned int *offsets, const unsigned int *targets);
 
 public:
     // CONSTRUCTOR AND DESTRUCTOR
@@ -39,19 +57,43 @@ public:
     /**
      * @brief Constructs the graph based on a given
      * input file 
-     * @param filename File containing the graph definition, in 'col' format
+     * @param filename File containing the graph definition, see GraphReader
+     * @param format Format of the file, detected by default
      */
-    Graph(std::string filename);
+    BasicGraph(std::string filename, GraphFormat format = FORMAT_AUTO);
+
+    /**
+     * @brief Constructs the graph from an edge array
+     * @param vertex_count Number of vertexes
+     * @param edges Pairs of different vertexes (numbered 0 through N-1), 2 * edge_count values
+     * @param edge_count Number of edges
+     */
+    BasicGraph(unsigned int vertex_count, const unsigned int *edges, unsigned int edge_count);
+
+    /**
+     * @brief Constructs the graph from a symmetric CSR adjacency structure
+     * @param vertex_count Number of vertexes
+     * @param offsets Row offsets, vertex_count + 1 values
+     * @param targets Adjacent vertexes of each row (numbered 0 through N-1), without the row's own vertex
+     */
+    BasicGraph(unsigned int vertex_count, const unsigned int *offsets, const unsigned int *targets);
 
     /**
      * @brief Copy constructor 
      */
-    Graph(Graph &graph);
+    BasicGraph(BasicGraph &graph);
+
+    /**
+     * @brief Copies a graph stored with another index width, with its coloring
+     * @param graph The copied graph, its vertexes must fit this graph's index width
+     */
+    template <typename Other>
+    BasicGraph(BasicGraph<Other> &graph);
 
     /**
      * @brief Graph destructor 
      */
-    ~Graph();
+    ~BasicGraph();
 
     // GETTERS
 
@@ -74,17 +116,17 @@ public:
     /**
      * @brief Returns the list of vertexes for this graph 
      */
-    std::vector<Vertex> getVertexes();
+    std::vector<BasicVertex<Index>> getVertexes();
 
     /**
      * @brief Returns the list of colors for this graph 
      */
-    std::vector<Color> getColors();
+    std::vector<BasicColor<Index>> getColors();
 
     /**
      * @brief Returns the list of colors that are used for this graph 
      */
-    std::vector<Color> getUsedColors();
+    std::vector<BasicColor<Index>> getUsedColors();
 
     /**
      * @brief Returns this list of edges for this graph 
@@ -96,41 +138,90 @@ public:
      * @param vertex_id Identifier for the wanted vertex
      * @returns Pointer to indexed vertex 
      */
-    Vertex *getVertex(unsigned int vertex_id);
+    BasicVertex<Index> *getVertex(unsigned int vertex_id);
 
     /**
      * @brief Returns a pointer to indexed color
      * @param color_id Identifier for the color
      * @returns Pointer to the indexed color
      */
-    Color *getColor(unsigned int color_id);
+    BasicColor<Index> *getColor(unsigned int color_id);
     
     // SETTERS
 
+    /**
+     * @brief Adds an edge between two different vertexes, loops are rejected
+     * @param first First vertex (numbered 0 through N-1)
+     * @param second Second vertex (numbered 0 through N-1)
+     */
+    void addEdge(unsigned int first, unsigned int second);
+
+    /**
+     * @brief Removes an edge added with addEdge() 
+     * @returns If the edge existed
+     */
+    bool removeEdge(unsigned int first, unsigned int second);
+
     /**
      * @brief Gives color to vertex
      * @param vertex_id The vertex
-     * @param color_id  The color
+     * @param color_id  The color, a used one or getUsedColorCount() to open a
+     * new one, any other color throws
      */
     void colorVertex(unsigned int vertex, unsigned int color);
 
     /**
-     * @brief Removes color from vertex 
+     * @brief Removes color from vertex. If that empties the color, the
+     * highest color is renumbered to it, so colors stay numbered 0 through k - 1
      * @param vertex_id
      */
     void cleanVertex(unsigned int vertex_id);
 
+    /**
+     * @brief Removes the color of every vertex 
+     */
+    void clearColoring();
+
     // INFORMATION
 
+    /**
+     * @brief Lists the vertexes that use a color
+     * @param color_id The color
+     * @param users Buffer that receives the users, in insertion order
+     */
+    void getUsers(unsigned int color_id, std::vector<unsigned int> &users);
+
     /**
      * @brief Checks if vertex can use the color 
      */
     bool canUse(unsigned int vertex_id, unsigned int color_id);
 
+    /**
+     * @brief Returns a hash of the vertex count and the sorted, duplicate
+     * free edge list, equal for equal graphs whatever the edge order
+     */
+    uint64_t getCanonicalHash();
+
+    /**
+     * @brief Returns the size of a clique found greedily from the highest
+     * degree vertexes, a lower bound for the number of colors
+     */
+    unsigned int getCliqueLowerBound();
+
+    /**
+     * @brief Writes the GLPK-ready param file for this graph 
+     * @param filename Output file
+     */
+    void exportGlpk(std::string filename);
+
     /**
      * @brief Returns general information about this graph 
      */
     std::string outputInfo();
 };
 
+// Graph with 32 bit ids, used for loading and transforming graphs, the
+// search picks the narrowest width that fits (see SimulatedAnnealing::create)
+typedef BasicGraph<uint32_t> Graph;
+
 #endif // GRAPH_H
@@ -0,0 +1,180 @@
+/**
+ * Graph file readers: DIMACS text and binary (.col.b), edge lists, METIS
+ * and MatrixMarket. The format is detected from the content and the file
+ * name. Files, compressed or not, and the standard input are read in large
+ * chunks (see InputStream) and numbers are parsed straight from them;
+ * every format produces an edge list that is turned into symmetric
+ * compressed rows, without loops and repeated edges, which the graph is
+ * built from.
+ */
+#ifndef GRAPH_READER_H
+#define GRAPH_READER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "InputStream.h"
+
+// Graph file formats
+enum GraphFormat
+{
+    FORMAT_AUTO,           // Detect from the content and the file name
+    FORMAT_DIMACS,         // DIMACS text: "p edge n m" and "e u v" lines, vertexes numbered from 1
+    FORMAT_DIMACS_BINARY,  // DIMACS binary: text preamble, then the lower triangle of the adjacency matrix
+    FORMAT_EDGE_LIST,      // "u v" lines, vertexes numbered from 0, "#" and "%" comments
+    FORMAT_METIS,          // "n m [fmt [ncon]]" header, then the neighbors of each vertex, numbered from 1
+    FORMAT_MATRIX_MARKET   // Coordinate matrix market, rows and columns numbered from 1
+};
+
+class GraphReader
+{
+private:
+    // Input, and its current chunk
+    InputStream *input;
+    const char *chunk;
+    unsigned long position;
+    unsigned long length;
+
+    // Current line, for error messages
+    unsigned long line;
+
+    // Format read
+    GraphFormat format;
+
+    // Vertexes, and edges as pairs of vertexes (numbered 0 through N-1)
+    unsigned int vertex_count;
+    std::vector<unsigned int> edges;
+
+    // Compressed rows built from the edges
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> targets;
+
+    /**
+     * @brief Moves to the next chunk of the input
+     * @returns False at the end of the input
+     */
+    bool refill();
+
+    /**
+     * @brief Returns the next byte without consuming it, or EOF
+     */
+    inline int peek()
+    {
+        if (this->position == this->length && !this->refill())
+            return EOF;
+
+        return (unsigned char)this->chunk[this->position];
+    }
+
+    /**
+     * @brief Consumes the next byte
+     */
+    inline void skip()
+    {
+        this->position++;
+    }
+
+    /**
+     * @brief Skips spaces, tabs and carriage returns, not line ends
+     */
+    void skipSpaces();
+
+    /**
+     * @brief Skips the rest of the line, and its end
+     */
+    void skipLine();
+
+    /**
+     * @brief Reads a decimal number of the current line, after spaces
+     * @returns False if the line has no more numbers
+     */
+    bool readNumber(unsigned long &value);
+
+    /**
+     * @brief Reads a word of the current line, after spaces
+     */
+    std::string readWord();
+
+    /**
+     * @brief Throws an error naming the current line
+     */
+    void fail(std::string message);
+
+    /**
+     * @brief Adds an edge between two vertexes, numbered from 0
+     */
+    void addEdge(unsigned long first, unsigned long second);
+
+    /**
+     * @brief Detects the format from the start of the file and its name
+     */
+    GraphFormat detect(std::string filename);
+
+    void readDimacs();
+    void readDimacsBinary();
+    void readEdgeList();
+    void readMetis();
+    void readMatrixMarket();
+
+    /**
+     * @brief Turns the edges into symmetric compressed rows, dropping
+     * loops and repeated edges
+     */
+    void buildRows();
+
+public:
+    /**
+     * @brief Reads a graph file
+     * @param filename The file, gzip, xz or zstd compressed or not, or "-"
+     * for the standard input
+     * @param file_format Its format, detected by default
+     */
+    GraphReader(std::string filename, GraphFormat file_format = FORMAT_AUTO);
+
+    /**
+     * @brief Reader destructor
+     */
+    ~GraphReader();
+
+    /**
+     * @brief Parses a format name: auto, dimacs, dimacs-binary, edges, metis or mtx
+     */
+    static GraphFormat parse(std::string name);
+
+    /**
+     * @brief Checks if a file name has the extension of a graph format:
+     * .col, .b, .edges, .el, .graph, .metis or .mtx, followed by .gz, .xz
+     * or .zst for compressed files
+     */
+    static bool isGraphFile(std::string filename);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the format read
+     */
+    GraphFormat getFormat();
+
+    /**
+     * @brief Returns the number of vertexes
+     */
+    unsigned int getVertexCount();
+
+    /**
+     * @brief Returns the row offsets, vertex_count + 1 values
+     */
+    const unsigned int *getOffsets();
+
+    /**
+     * @brief Returns the adjacent vertexes of every row
+     */
+    const unsigned int *getTargets();
+};
+
+#endif // GRAPH_READER_H
@@ -0,0 +1,31 @@
+/**
+ * Vertex and color index widths. The graph core stores its ids with the
+ * narrowest unsigned type that fits the graph: 16 bits when there are
+ * fewer than 65535 vertexes (and so colors), 32 bits otherwise. -1 marks
+ * a missing vertex or color in every width.
+ */
+#ifndef INDEX_H
+#define INDEX_H
+
+#include <cstdint>
+
+/**
+ * @brief Checks if every id of a graph with the given number of vertexes,
+ * and the -1 marker, fit in the index type
+ */
+template <typename Index>
+inline bool fitsIndex(unsigned int vertex_count)
+{
+    return vertex_count < (Index)-1;
+}
+
+/**
+ * @brief Widens a stored id to unsigned int, keeping the -1 marker
+ */
+template <typename Index>
+inline unsigned int widenIndex(Index index)
+{
+    return index == (Index)-1 ? (unsigned int)-1 : (unsigned int)index;
+}
+
+#endif // INDEX_H
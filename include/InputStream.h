@@ -0,0 +1,138 @@
+/**
+ * Chunked input of a file or the standard input, decompressing gzip, xz
+ * and zstd streams, detected by their magic bytes. Compressed input is
+ * decompressed by a separate thread into a few fixed buffers handed to
+ * the reader in turn, so decompression and parsing overlap and memory
+ * does not grow with the uncompressed size.
+ *
+ * Each decompressor is compiled in with its library: gzip and xz by
+ * default, zstd with 'make ZSTD=1' (see the Makefile).
+ */
+#ifndef INPUT_STREAM_H
+#define INPUT_STREAM_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef WITH_LZMA
+#include <lzma.h>
+#endif
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+
+// Compression of an input
+enum Compression
+{
+    COMPRESSION_NONE,
+    COMPRESSION_GZIP,
+    COMPRESSION_XZ,
+    COMPRESSION_ZSTD
+};
+
+class InputStream
+{
+private:
+    // Size of every buffer, and buffers of decompressed data
+    static const unsigned long CHUNK_SIZE = 1ul << 20;
+    static const unsigned int BUFFER_COUNT = 4;
+
+    // Input file, the standard input for "-"
+    FILE *file;
+
+    // Compression detected
+    Compression compression;
+
+    // Start of the input, read to detect the compression
+    std::vector<char> head;
+    unsigned long head_length;
+    bool head_taken;
+
+    // Decompressed buffers, the ones free to fill and the ones ready to
+    // read (with their sizes), and the one the reader holds (or -1)
+    std::vector<std::vector<char>> buffers;
+    std::deque<unsigned int> free_buffers;
+    std::deque<std::pair<unsigned int, unsigned long>> ready;
+    int current;
+
+    // Decompression thread and its state, guarded by the lock
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable changed;
+    bool finished;
+    bool stopping;
+    std::string error;
+
+    /**
+     * @brief Reads raw bytes of the input, the detection head first
+     * @returns Bytes read, 0 at the end of the input
+     */
+    unsigned long readRaw(char *data, unsigned long size);
+
+    /**
+     * @brief Waits for a free buffer
+     * @returns Its index, or -1 if the reader stopped
+     */
+    int acquire();
+
+    /**
+     * @brief Hands a filled buffer to the reader
+     */
+    void publish(unsigned int index, unsigned long size);
+
+    /**
+     * @brief Decompression thread: decompresses the whole input, then
+     * marks the stream finished, with the error if one happened
+     */
+    void decompress();
+
+    void inflateGzip();
+    void decodeXz();
+    void decodeZstd();
+
+public:
+    /**
+     * @brief Opens an input
+     * @param filename The file, or "-" for the standard input
+     */
+    InputStream(std::string filename);
+
+    /**
+     * @brief Stops the decompression and closes the input
+     */
+    ~InputStream();
+
+    /**
+     * @brief Returns the next chunk of (decompressed) input, valid until
+     * the next call
+     * @param data Receives the chunk
+     * @param size Receives its size
+     * @returns False at the end of the input
+     */
+    bool next(const char *&data, unsigned long &size);
+
+    /**
+     * @brief Returns a file name without its compression extension (.gz,
+     * .xz or .zst)
+     */
+    static std::string stripCompression(std::string filename);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the compression detected
+     */
+    Compression getCompression();
+};
+
+#endif // INPUT_STREAM_H
@@ -0,0 +1,178 @@
+/**
+ * Compile-time removable instrumentation for the Simulated Annealing hot path.
+ *
+ * When compiled with -DINSTRUMENTATION (make INSTRUMENT=1) the INSTRUMENT_*
+ * macros record per-phase tick counters, move and acceptance counters and
+ * heap allocations. Otherwise every macro expands to nothing. Counters are
+ * relaxed atomics, so concurrent runs (batch mode) are summed together.
+ */
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Timed phases of the algorithm
+enum Phase
+{
+    PHASE_NEIGHBOR_GENERATION, // Includes PHASE_LOCAL_SEARCH
+    PHASE_LOCAL_SEARCH,
+    PHASE_ACCEPTANCE,
+    PHASE_LOGGING,
+    PHASE_DELETION,
+    PHASE_COUNT
+};
+
+// Event counters
+enum Counter
+{
+    COUNTER_RANDOMIZE_MOVES,
+    COUNTER_LOCAL_SEARCH_MOVES,
+    COUNTER_ACCEPTED,
+    COUNTER_REJECTED,
+    COUNTER_UPHILL,
+    COUNTER_BEST_IMPROVEMENTS,
+    COUNTER_STATE_ALLOCATIONS,
+    COUNTER_COUNT
+};
+
+class Instrumentation
+{
+private:
+    // Accumulated ticks and number of measurements for each phase
+    static std::atomic<unsigned long long> ticks[PHASE_COUNT];
+    static std::atomic<unsigned long long> calls[PHASE_COUNT];
+
+    // Event counters
+    static std::atomic<unsigned long long> counters[COUNTER_COUNT];
+
+    // Accepted and evaluated neighbors per temperature band (floor(log10(t))),
+    // fixed size so that recording never allocates
+    static const int BAND_OFFSET = 32;
+    static const int BAND_COUNT = 64;
+    static std::atomic<unsigned long long> band_accepted[BAND_COUNT];
+    static std::atomic<unsigned long long> band_evaluated[BAND_COUNT];
+
+    // Heap allocations when the steady state began and ended
+    static unsigned long long steady_state_begin;
+    static unsigned long long steady_state_end;
+
+    // Reference points used to convert ticks to seconds
+    static unsigned long long start_ticks;
+    static std::chrono::steady_clock::time_point start_time;
+
+public:
+    // Heap allocations performed by the process (operator new calls)
+    static std::atomic<unsigned long long> heap_allocations;
+
+    /**
+     * @brief Returns a monotonic tick count (TSC when available)
+     */
+    static inline unsigned long long now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /**
+     * @brief Adds elapsed ticks to a phase
+     * @param phase The phase being measured
+     * @param elapsed Elapsed ticks
+     */
+    static inline void addTicks(Phase phase, unsigned long long elapsed)
+    {
+        ticks[phase].fetch_add(elapsed, std::memory_order_relaxed);
+        calls[phase].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Increments an event counter
+     * @param counter The counter
+     * @param n Increment
+     */
+    static inline void count(Counter counter, unsigned long long n = 1)
+    {
+        counters[counter].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records the acceptance outcome of one temperature step
+     * @param temperature Temperature of the step
+     * @param accepted Number of accepted neighbors
+     * @param evaluated Number of evaluated neighbors
+     */
+    static void recordBand(double temperature, unsigned long long accepted, unsigned long long evaluated);
+
+    /**
+     * @brief Marks the start of the steady state, heap allocations
+     * from this point on are reported separately
+     */
+    static void steadyStateBegin();
+
+    /**
+     * @brief Marks the end of the steady state
+     */
+    static void steadyStateEnd();
+
+    /**
+     * @brief Returns the current value of a counter
+     */
+    static unsigned long long get(Counter counter);
+
+    /**
+     * @brief Writes the collected summary as JSON
+     * @param filename Output file
+     */
+    static void writeJson(std::string filename);
+
+    /**
+     * @brief Registers the JSON summary to be written when the process exits
+     * @param filename Output file
+     */
+    static void dumpAtExit(std::string filename);
+};
+
+/**
+ * Scoped phase timer, adds the ticks spent in its scope to a phase
+ */
+class PhaseTimer
+{
+private:
+    Phase phase;
+    unsigned long long begin;
+
+public:
+    PhaseTimer(Phase timed_phase) : phase(timed_phase), begin(Instrumentation::now()) {}
+    ~PhaseTimer() { Instrumentation::addTicks(this->phase, Instrumentation::now() - this->begin); }
+};
+
+#ifdef INSTRUMENTATION
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+#define INSTRUMENT_PHASE(phase) PhaseTimer INSTRUMENT_CONCAT(phase_timer_, __LINE__)(phase)
+#define INSTRUMENT_COUNT(counter) Instrumentation::count(counter)
+#define INSTRUMENT_COUNT_N(counter, n) Instrumentation::count(counter, n)
+#define INSTRUMENT_BAND(temperature, accepted, evaluated) Instrumentation::recordBand(temperature, accepted, evaluated)
+#define INSTRUMENT_STEADY_STATE_BEGIN() Instrumentation::steadyStateBegin()
+#define INSTRUMENT_STEADY_STATE_END() Instrumentation::steadyStateEnd()
+#define INSTRUMENT_DUMP_AT_EXIT(filename) Instrumentation::dumpAtExit(filename)
+#else
+// Still statements, so "if (...) INSTRUMENT_COUNT(...);" has a body
+#define INSTRUMENT_PHASE(phase) ((void)0)
+#define INSTRUMENT_COUNT(counter) ((void)0)
+#define INSTRUMENT_COUNT_N(counter, n) ((void)0)
+#define INSTRUMENT_BAND(temperature, accepted, evaluated) ((void)0)
+#define INSTRUMENT_STEADY_STATE_BEGIN() ((void)0)
+#define INSTRUMENT_STEADY_STATE_END() ((void)0)
+#define INSTRUMENT_DUMP_AT_EXIT(filename) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,68 @@
+/**
+ * Command line parsing: positional arguments plus '--name' and
+ * '--name=value' options, which may appear anywhere.
+ */
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class Options
+{
+private:
+    // Options given as --name or --name=value
+    std::map<std::string, std::string> options;
+
+    // Every other argument, in order
+    std::vector<std::string> arguments;
+
+public:
+    /**
+     * @brief Parses the command line
+     */
+    Options(int argc, char **argv);
+
+    /**
+     * @brief Options destructor 
+     */
+    ~Options();
+
+    /**
+     * @brief Checks if an option was given
+     * @param name Option name, without the leading dashes
+     */
+    bool has(std::string name);
+
+    /**
+     * @brief Returns an option's value
+     * @param name Option name, without the leading dashes
+     * @param fallback Value returned when the option was not given
+     */
+    std::string get(std::string name, std::string fallback = "");
+
+    /**
+     * @brief Returns an option's value as a number, throwing if the value
+     * is not a number
+     * @param name Option name, without the leading dashes
+     * @param fallback Value returned when the option was not given
+     */
+    double getNumber(std::string name, double fallback);
+
+    /**
+     * @brief Returns the first option given that is not in a list
+     * @param known Option names, without the leading dashes
+     * @returns The unknown option, or an empty string if there is none
+     */
+    std::string findUnknown(const std::vector<std::string> &known);
+
+    /**
+     * @brief Returns the positional arguments 
+     */
+    const std::vector<std::string> &getArguments();
+};
+
+#endif // OPTIONS_H
@@ -0,0 +1,87 @@
+/**
+ * Pseudo-random number generator (xoshiro256**), one instance per run so
+ * that concurrent runs use independent, reproducible streams.
+ */
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+class Random
+{
+private:
+    // Generator state
+    uint64_t s[4];
+
+public:
+    /**
+     * @brief Generator constructor
+     * @param seed Seed for the generator
+     * @param stream Stream identifier, different streams with the same seed are independent
+     */
+    Random(uint64_t seed = 1, uint64_t stream = 0);
+
+    /**
+     * @brief Generator destructor 
+     */
+    ~Random();
+
+    /**
+     * @brief Restarts the generator
+     * @param seed Seed for the generator
+     * @param stream Stream identifier
+     */
+    void seed(uint64_t seed, uint64_t stream = 0);
+
+    /**
+     * @brief Returns the next 64 random bits 
+     */
+    inline uint64_t next64()
+    {
+        uint64_t result = rotl(this->s[1] * 5, 7) * 9;
+        uint64_t t = this->s[1] << 17;
+
+        this->s[2] ^= this->s[0];
+        this->s[3] ^= this->s[1];
+        this->s[1] ^= this->s[2];
+        this->s[0] ^= this->s[3];
+        this->s[2] ^= t;
+        this->s[3] = rotl(this->s[3], 45);
+
+        return result;
+    }
+
+    /**
+     * @brief Returns a random number between 0 and RAND_MAX, like random()
+     */
+    inline long next()
+    {
+        return (long)(this->next64() >> 33);
+    }
+
+    /**
+     * @brief Returns a random number in [0, 1)
+     */
+    inline double uniform()
+    {
+        return (this->next64() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * @brief Returns the generator state, for checkpointing
+     */
+    const uint64_t *getState();
+
+    /**
+     * @brief Restores a generator state returned by getState()
+     */
+    void setState(const uint64_t *state);
+
+private:
+    static inline uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+};
+
+#endif // RANDOM_H
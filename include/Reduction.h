@@ -0,0 +1,98 @@
+/**
+ * Graph reduction before coloring with fewer than k colors: vertexes with
+ * degree < k - 1 are peeled recursively (k-core style) and vertexes whose
+ * neighborhood is contained in a non-adjacent vertex's neighborhood are
+ * dropped. Removed vertexes are colored back in reverse removal order.
+ */
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Graph.h"
+#include "Snapshot.h"
+
+class Reduction
+{
+private:
+    // Number of vertexes of the original graph
+    unsigned int vertex_count;
+
+    // Duplicate free adjacency of the original graph
+    std::vector<std::vector<unsigned int>> adjacent;
+
+    // Original id of every vertex of the reduced graph
+    std::vector<unsigned int> kept;
+
+    // Removed vertexes, in removal order, and the vertex dominating each
+    // one (-1 for vertexes peeled by degree)
+    std::vector<unsigned int> removed;
+    std::vector<unsigned int> dominator;
+
+    // The reduced graph
+    Graph *reduced;
+
+    // Largest adjacency matrix used by the domination check, in bytes
+    static const unsigned long MAX_BITSET_BYTES = 64ul << 20;
+
+    /**
+     * @brief Removes dominated vertexes, using adjacency bitsets when they
+     * fit in MAX_BITSET_BYTES and the sorted adjacency lists otherwise
+     * @param present Vertexes not yet removed
+     * @param degree Current degree of every vertex
+     * @returns If any vertex was removed
+     */
+    bool removeDominated(std::vector<bool> &present, std::vector<unsigned int> &degree);
+
+    /**
+     * @brief Returns if every present neighbor of u is a neighbor of v
+     */
+    bool contains(unsigned int v, unsigned int u, const std::vector<bool> &present);
+
+    /**
+     * @brief Removes a vertex, updating its neighbors' degrees
+     */
+    void remove(unsigned int vertex, unsigned int by, std::vector<bool> &present, std::vector<unsigned int> &degree);
+
+public:
+    /**
+     * @brief Reduces a graph for a search with fewer than k colors
+     * @param graph The original graph
+     * @param k Colors used by the best known coloring
+     */
+    Reduction(Graph &graph, unsigned int k);
+
+    /**
+     * @brief Reduction destructor 
+     */
+    ~Reduction();
+
+    /**
+     * @brief Returns the reduced graph, vertexes renumbered from 0 
+     */
+    Graph &getReduced();
+
+    /**
+     * @brief Returns the number of removed vertexes 
+     */
+    unsigned int getRemovedCount();
+
+    /**
+     * @brief Restricts a coloring of the original graph to the reduced graph
+     * @param full Coloring of the original graph
+     * @param reduced_coloring Receives the coloring of the reduced graph
+     */
+    void restrict(Snapshot &full, Snapshot &reduced_coloring);
+
+    /**
+     * @brief Colors the removed vertexes back, the result uses as many colors
+     * as the reduced coloring, or k - 1 if that is more
+     * @param reduced_coloring Coloring of the reduced graph
+     * @param full Receives the coloring of the original graph
+     */
+    void expand(Snapshot &reduced_coloring, Snapshot &full);
+};
+
+#endif // REDUCTION_H
@@ -0,0 +1,79 @@
+/**
+ * Vertex renumbering for cache locality: neighbors get nearby ids, so the
+ * adjacency scans of the search touch nearby entries of the vertex set.
+ * The inverse permutation maps colorings back to the original ids.
+ */
+#ifndef REORDERING_H
+#define REORDERING_H
+
+#include <string>
+#include <vector>
+
+#include "Graph.h"
+#include "Snapshot.h"
+
+// Available vertex orders
+enum VertexOrder
+{
+    ORDER_INPUT,  // Keep the input numbering
+    ORDER_DEGREE, // Highest degree first
+    ORDER_BFS,    // Breadth-first search from a lowest degree vertex
+    ORDER_RCM     // Reverse Cuthill-McKee
+};
+
+class Reordering
+{
+private:
+    // Original id of every new id, and new id of every original id
+    std::vector<unsigned int> order;
+    std::vector<unsigned int> position;
+
+    // The renumbered graph
+    Graph *permuted;
+
+    /**
+     * @brief Breadth-first order of every component, each started from a
+     * lowest degree vertex
+     * @param graph The graph
+     * @param by_degree Visit the neighbors of a vertex by increasing degree (Cuthill-McKee)
+     */
+    void breadthFirst(Graph &graph, bool by_degree);
+
+public:
+    /**
+     * @brief Renumbers a graph
+     * @param graph The original graph
+     * @param vertex_order The order of the new ids
+     */
+    Reordering(Graph &graph, VertexOrder vertex_order);
+
+    /**
+     * @brief Reordering destructor 
+     */
+    ~Reordering();
+
+    /**
+     * @brief Returns the renumbered graph 
+     */
+    Graph &getPermuted();
+
+    /**
+     * @brief Renumbers a coloring of the original graph
+     * @param original Coloring of the original graph
+     * @param renumbered Receives the coloring of the renumbered graph
+     */
+    void permute(Snapshot &original, Snapshot &renumbered);
+
+    /**
+     * @brief Maps a coloring of the renumbered graph back to the original ids
+     * @param coloring Color of each vertex, replaced in place
+     */
+    void restore(std::vector<unsigned int> &coloring);
+
+    /**
+     * @brief Parses an order name: input, degree, bfs or rcm
+     */
+    static VertexOrder parse(std::string name);
+};
+
+#endif // REORDERING_H
@@ -3,49 +3,285 @@
 
 #include <chrono>
 #include <cmath>
+#include <functional>
+#include <map>
+#include <mutex>
 
+#include "AnnealingPolicies.h"
+#include "Checkpoint.h"
 #include "State.h"
+#include "StatePool.h"
+#include "ElitePool.h"
 #include "Graph.h"
+#include "Index.h"
+#include "Instrumentation.h"
+#include "Random.h"
 
-// ./app <seed> <temperature> <constant> <cooling-factor> <max-neighbors> <max-iterations> <input-file>
-int main(int argc, char **argv);
+// Progress of the algorithm, reported after every temperature step
+struct Progress
+{
+    unsigned long iteration;
+    double temperature;
+    unsigned int current_value;
+    unsigned int best_value;
+    unsigned int accepted;
+    unsigned int evaluated;
+    double elapsed_seconds;
+    bool finished;
+
+    // Iteration and time at which the best value was first reached
+    unsigned long best_iteration;
+    double best_seconds;
+
+    /**
+     * @brief Serializes the progress as a single line JSON object
+     */
+    std::string toJson() const;
+};
 
+/**
+ * Simulated Annealing run. The search itself is instantiated for every
+ * index width and policy combination, create() picks the one used.
+ */
 class SimulatedAnnealing
 {
+public:
+    /**
+     * @brief Creates a run on the given graph, stored with the narrowest
+     * index width that fits it (see Index.h)
+     * @param graph          Graph being colored
+     * @param random         Random number generator, copied to the run
+     * @param t              Temperature
+     * @param r              Cooling factor
+     * @param k              Constant
+     * @param max_neighbors  Number of neighbors generated per iteration
+     * @param max_iterations Maximum number of iterations allowed
+     * @param policies       Move set, acceptance rule and cooling schedule
+     * @returns New run, owned by the caller
+     */
+    static SimulatedAnnealing *create(Graph &graph, Random random, double t, double k, double r, unsigned int max_neighbors, unsigned int max_iterations,
+                                      const AnnealingPolicies &policies = AnnealingPolicies());
+
+    /**
+     * @brief Throws if there is no run with the given policies
+     */
+    static void checkPolicies(const AnnealingPolicies &policies);
+
+    /**
+     * @brief Class destructor 
+     */
+    virtual ~SimulatedAnnealing();
+
+    // OUTPUT OPTIONS
+
+    /**
+     * @brief Enables or disables the [INFO] output to stdout
+     */
+    virtual void setVerbose(bool enabled) = 0;
+
+    /**
+     * @brief Enables the plotting log files, disabled by default
+     * @param log File with the current state value of each iteration
+     * @param neighbors File with the neighbor values of each iteration
+     */
+    virtual void setLogFiles(std::string log, std::string neighbors) = 0;
+
+    /**
+     * @brief Sets a function called with the progress after every temperature step
+     */
+    virtual void setProgressCallback(std::function<void(const Progress &)> callback) = 0;
+
+    /**
+     * @brief Enables periodic checkpoints, written off the hot path
+     * @param filename Checkpoint file, replaced atomically
+     * @param interval Number of iterations between checkpoints
+     */
+    virtual void setCheckpoint(std::string filename, unsigned long interval) = 0;
+
+    /**
+     * @brief Continues a checkpointed run instead of starting a new one,
+     * must be called before the run starts
+     * @param checkpoint Checkpoint of a run on the same graph with the same
+     * policies, copied
+     */
+    virtual void resume(Checkpoint &checkpoint) = 0;
+
+    /**
+     * @brief Starts from the given coloring instead of the greedy start,
+     * must be called before the run starts
+     * @param coloring A valid coloring of the graph, copied
+     */
+    virtual void setInitialColoring(Snapshot &coloring) = 0;
+
+    /**
+     * @brief Runs the simulated annealing algorithm until it stops
+     */
+    virtual void run() = 0;
+
+    /**
+     * @brief Runs at most the given number of iterations (temperature steps)
+     * and returns control, so that many runs can be interleaved
+     * @param n_iterations Maximum number of iterations to run
+     * @returns True while the run has not finished
+     */
+    virtual bool step(unsigned long n_iterations) = 0;
+
+    /**
+     * @brief Stops the run, the next call to step() finishes it
+     */
+    virtual void cancel() = 0;
+
+    /**
+     * @brief Returns if the run has finished 
+     */
+    virtual bool isFinished() = 0;
+
+    /**
+     * @brief Returns the current progress of the run 
+     */
+    virtual Progress getProgress() = 0;
+
+    // RESULTS
+
+    /**
+     * @brief Returns the best coloring found by the last run 
+     */
+    virtual Snapshot *getBest() = 0;
+
+    /**
+     * @brief Returns if the best coloring found is a valid coloring 
+     */
+    virtual bool isCorrect() = 0;
+
+    /**
+     * @brief Returns the number of iterations of the last run 
+     */
+    virtual unsigned long getIterations() = 0;
+
+    /**
+     * @brief Returns the duration of the last run, in seconds 
+     */
+    virtual double getElapsedSeconds() = 0;
+
+    /**
+     * @brief Returns the best distinct states visited during the run 
+     */
+    virtual ElitePool *getElite() = 0;
+};
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+class BasicSimulatedAnnealing : public SimulatedAnnealing
+{
 private:
     // Input graph
-    Graph G;
+    BasicGraph<Index> G;
+
+    // Random number generator of this run
+    Random rng;
+
+    // Best distinct states visited, for restarts
+    static const unsigned int ELITE_SIZE = 8;
+    ElitePool elite;
 
     // Algorithm values
     double temperature;
-    double cooling_factor;
     double constant_k;
 
-    double temperature_min;
+    // Policies, see AnnealingPolicies.h
+    Objective objective;
+    Moves moves;
+    Acceptance acceptance;
+    Schedule schedule;
+
     ulong max_neighbors;
     ulong max_iterations;
 
-public:
+    // Output options
+    bool verbose;
+    std::string log_filename;
+    std::string neighbors_filename;
+    std::function<void(const Progress &)> progress_callback;
+
+    // Checkpointing, every checkpoint_interval iterations when enabled
+    std::string checkpoint_filename;
+    unsigned long checkpoint_interval;
+    CheckpointWriter *checkpoint_writer;
+    uint64_t graph_hash;
+
+    // Starting point other than the greedy start, used once by start()
+    Checkpoint *resume_checkpoint;
+    Snapshot *initial_coloring;
+
+    // Execution state, kept between calls to step()
+    bool started;
+    bool finished;
+    bool cancelled;
+    BasicState<Index> *current_state;
+    BasicStatePool<Index> *pool;
+    std::vector<BasicState<Index> *> neighbors;
+    unsigned long iteration_number;
+    double prob_kt;
+    unsigned int last_accepted;
+    std::ofstream log_file;
+    std::ofstream neigh_file;
+    std::chrono::steady_clock::time_point step_start;
+
+    // Results, with the iteration and time the best state was found
+    Snapshot best;
+    unsigned long best_iteration;
+    double best_seconds;
+    bool correct;
+    unsigned long iterations;
+    double elapsed_seconds;
+
     /**
-     * @brief Algorithm constructor
-     * @param t              Temperature
-     * @param r              Cooling factor
-     * @param k              Constant
-     * @param max_neighbors  Number of neighbors generated per iteration
-     * @param max_iterations Maximum number of iterations allowed
-     * @param filename       File containing graph
+     * @brief Generates the starting state and prepares the run 
      */
-    SimulatedAnnealing(double t, double k, double r, unsigned int max_neighbors, unsigned int max_iterations, std::string filename);
+    void start();
 
     /**
-     * @brief Class destructor 
+     * @brief Runs one temperature step: generates and evaluates every neighbor 
      */
-    ~SimulatedAnnealing();
+    void iterate();
 
     /**
-     * @brief Starts the simulated annealing algorithm 
+     * @brief Builds and checks the best state, closes the run 
      */
-    void run();
+    void finish();
+
+    /**
+     * @brief Hands the position of the run to the checkpoint writer 
+     */
+    void checkpoint();
+
+public:
+    /**
+     * @brief Algorithm constructor, see SimulatedAnnealing::create()
+     * @param graph Graph being colored, copied with this index width
+     */
+    BasicSimulatedAnnealing(Graph &graph, Random random, double t, double k, double r, unsigned int max_neighbors, unsigned int max_iterations, const AnnealingPolicies &policies);
+
+    /**
+     * @brief Class destructor 
+     */
+    ~BasicSimulatedAnnealing();
+
+    void setVerbose(bool enabled) override;
+    void setLogFiles(std::string log, std::string neighbors) override;
+    void setProgressCallback(std::function<void(const Progress &)> callback) override;
+    void setCheckpoint(std::string filename, unsigned long interval) override;
+    void resume(Checkpoint &checkpoint) override;
+    void setInitialColoring(Snapshot &coloring) override;
+    void run() override;
+    bool step(unsigned long n_iterations) override;
+    void cancel() override;
+    bool isFinished() override;
+    Progress getProgress() override;
+    Snapshot *getBest() override;
+    bool isCorrect() override;
+    unsigned long getIterations() override;
+    double getElapsedSeconds() override;
+    ElitePool *getElite() override;
 };
 
 #endif // SIMULATED_ANNEALING_H
@@ -0,0 +1,143 @@
+/**
+ * Compact copy of a coloring: one color per vertex, stored in 16 bits
+ * when every color fits, 32 bits otherwise, plus the coloring's value.
+ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "Graph.h"
+
+class Snapshot
+{
+private:
+    // Value of the stored coloring
+    unsigned int value;
+
+    // Number of vertexes in the stored coloring
+    unsigned int vertex_count;
+
+    // Bytes used per color (2 or 4)
+    unsigned int width;
+
+    // Color of each vertex, packed with the above width
+    std::vector<unsigned char> colors;
+
+public:
+    /**
+     * @brief Snapshot constructor, creates an empty snapshot 
+     */
+    Snapshot();
+
+    /**
+     * @brief Snapshot destructor 
+     */
+    ~Snapshot();
+
+    /**
+     * @brief Reserves room for a coloring with the given amount of vertexes
+     */
+    void reserve(unsigned int vertexes);
+
+    /**
+     * @brief Stores the coloring of a graph
+     * @param graph The colored graph
+     * @param coloring_value Value of the coloring
+     */
+    template <typename Index>
+    void capture(BasicGraph<Index> &graph, unsigned int coloring_value);
+
+    /**
+     * @brief Copies another snapshot with a single memcpy
+     * @param snapshot The copied snapshot
+     */
+    void copyFrom(Snapshot &snapshot);
+
+    /**
+     * @brief Applies the stored coloring to a graph with the same vertexes
+     * @param graph The graph being colored
+     */
+    template <typename Index>
+    void restore(BasicGraph<Index> &graph);
+
+    /**
+     * @brief Checks if the snapshot colors every vertex of a graph with the
+     * given number of vertexes, with colors 0 through vertexes - 1
+     */
+    bool fits(unsigned int vertexes);
+
+    /**
+     * @brief Checks if another snapshot stores the same coloring
+     */
+    bool sameColoring(Snapshot &snapshot);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the value of the stored coloring 
+     */
+    unsigned int getValue();
+
+    /**
+     * @brief Returns the number of vertexes in the stored coloring 
+     */
+    unsigned int getVertexCount();
+
+    /**
+     * @brief Returns the stored color of a vertex
+     * @param vertex_id The vertex
+     */
+    unsigned int getColor(unsigned int vertex_id);
+
+    /**
+     * @brief Swaps the contents of two snapshots without copying
+     */
+    void swap(Snapshot &snapshot);
+
+    // SERIALIZATION
+
+    /**
+     * @brief Writes the snapshot in binary form
+     * @returns If every byte was written
+     */
+    bool write(FILE *file);
+
+    /**
+     * @brief Reads a snapshot written by write()
+     * @param vertexes Expected number of vertexes, checked before the
+     * colors are allocated
+     * @returns If a complete snapshot of that size was read
+     */
+    bool read(FILE *file, unsigned int vertexes);
+
+    /**
+     * @brief Returns the number of bytes left to read in a file, bounding
+     * what a damaged length field can make a reader allocate
+     */
+    static unsigned long remainingBytes(FILE *file);
+
+    /**
+     * @brief Stores a coloring given as one color per vertex, colors may be
+     * any numbers, they are renumbered from 0 in order of first appearance
+     * @param coloring Color of each vertex
+     */
+    void assign(const std::vector<unsigned int> &coloring);
+
+    /**
+     * @brief Reads a coloring from a text file with one color per vertex,
+     * in vertex order. Colors may be any numbers, they are renumbered from 0
+     * @param filename The coloring file
+     * @param vertexes Number of vertexes of the colored graph
+     */
+    void readColoring(std::string filename, unsigned int vertexes);
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,74 @@
+/**
+ * On-disk store of the best known coloring of every graph, keyed by the
+ * graph's canonical hash. Entries are replaced only by better colorings,
+ * under a file lock, so that concurrent runs on a host share their results.
+ */
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include "Graph.h"
+#include "Snapshot.h"
+
+class SolutionCache
+{
+private:
+    // Directory holding one entry and one lock file per graph
+    std::string directory;
+
+    /**
+     * @brief Returns the entry path of a graph, without extension
+     */
+    std::string getEntryPath(Graph &graph);
+
+    /**
+     * @brief Reads an entry, if it exists and is a valid coloring of the graph
+     */
+    static bool readEntry(std::string filename, Graph &graph, Snapshot &coloring);
+
+public:
+    /**
+     * @brief Opens a cache, creating its directory if needed
+     * @param directory Cache directory
+     */
+    SolutionCache(std::string directory);
+
+    /**
+     * @brief Cache destructor 
+     */
+    ~SolutionCache();
+
+    /**
+     * @brief Returns the best known coloring of a graph
+     * @param graph The graph
+     * @param coloring Receives the coloring
+     * @returns If a valid coloring was found
+     */
+    bool lookup(Graph &graph, Snapshot &coloring);
+
+    /**
+     * @brief Stores a coloring if it is better than the known one
+     * @param graph The colored graph
+     * @param coloring A valid coloring of the graph
+     * @returns If the coloring was stored
+     */
+    bool store(Graph &graph, Snapshot &coloring);
+
+    /**
+     * @brief Checks if a coloring needs no further search: it uses at most
+     * target colors, or as many as the graph's clique lower bound
+     * @param graph The colored graph
+     * @param coloring The coloring
+     * @param target Target number of colors (0 for none)
+     */
+    static bool isSolved(Graph &graph, Snapshot &coloring, unsigned int target);
+};
+
+#endif // SOLUTION_CACHE_H
@@ -0,0 +1,255 @@
+/**
+ * Embeddable graph coloring solver. Colors graphs built in memory with
+ * the Simulated Annealing algorithm, without touching the file system.
+ */
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <functional>
+#include <vector>
+
+#include "BranchAndBound.h"
+#include "Decomposition.h"
+#include "Evolution.h"
+#include "Graph.h"
+#include "Reduction.h"
+#include "Reordering.h"
+#include "SimulatedAnnealing.h"
+#include "ThreadPool.h"
+
+// Algorithm parameters, defaults match the ones used by 'make test'
+struct SolverParameters
+{
+    unsigned long seed = 2;
+    unsigned long stream = 0;
+    double temperature = 1;
+    double constant = 10;
+    double cooling_factor = 0.99;
+    unsigned int max_neighbors = 12;
+    unsigned int max_iterations = 9999;
+
+    // Move set, acceptance rule and cooling schedule, see AnnealingPolicies.h
+    AnnealingPolicies policies;
+
+    // Renumber the vertexes for cache locality, see Reordering
+    VertexOrder order = ORDER_INPUT;
+
+    // Shrink the graph before searching, see Reduction
+    bool reduce = false;
+
+    // Color every connected component on its own, on this many threads (0 uses every core)
+    bool decompose = false;
+    unsigned int threads = 0;
+
+    // Evolve a population of colorings with crossover, each offspring improved
+    // with a run of max_iterations, instead of a single run, see Evolution
+    bool evolve = false;
+    unsigned int population = 10;
+    unsigned int generations = 50;
+
+    // Improve the coloring and prove it optimal with DSATUR branch and
+    // bound after the search, for at most exact_seconds, see BranchAndBound
+    bool exact = false;
+    double exact_seconds = 10;
+};
+
+// Statistics of a solve
+struct SolverStatistics
+{
+    unsigned long iterations = 0;
+    double elapsed_seconds = 0;
+
+    // Iteration and time at which the final number of colors was first
+    // reached (time to k), the slowest component's with components
+    unsigned long best_iteration = 0;
+    double best_seconds = 0;
+
+    // Vertexes removed by the last reduction, when enabled
+    unsigned int removed_vertices = 0;
+
+    // Connected components, and how many were colored without searching
+    unsigned int components = 1;
+    unsigned int trivial_components = 0;
+
+    // Branch and bound nodes, when enabled
+    unsigned long exact_nodes = 0;
+};
+
+// Result of a solve
+struct SolverResult
+{
+    // Color of each vertex (numbered 0 through N-1)
+    std::vector<unsigned int> coloring;
+
+    // Number of colors used
+    unsigned int color_count = 0;
+
+    // If the coloring satisfies every edge
+    bool correct = false;
+
+    // If the number of colors is proven optimal, by the branch and bound
+    // or because every component needing that many is a clique or bipartite
+    bool optimal = false;
+
+    SolverStatistics statistics;
+};
+
+/**
+ * A single resumable solve, advanced a few iterations at a time so that
+ * one thread can interleave many of them
+ */
+class SolverJob
+{
+private:
+    // The running algorithm, owned by the job
+    SimulatedAnnealing *algorithm;
+
+public:
+    /**
+     * @brief Job constructor, the algorithm starts on the first step
+     * @param graph The uncolored graph
+     * @param parameters Algorithm parameters
+     */
+    SolverJob(Graph &graph, SolverParameters parameters);
+
+    /**
+     * @brief Job destructor 
+     */
+    ~SolverJob();
+
+    /**
+     * @brief Sets a function called with the progress after every temperature step
+     */
+    void setProgressCallback(std::function<void(const Progress &)> callback);
+
+    /**
+     * @brief Starts from the given coloring instead of the greedy start,
+     * must be called before the first step
+     * @param coloring A valid coloring of the graph
+     */
+    void setInitialColoring(Snapshot &coloring);
+
+    /**
+     * @brief Runs at most n_iterations temperature steps
+     * @returns True while the job has not finished
+     */
+    bool step(unsigned long n_iterations);
+
+    /**
+     * @brief Cancels the job, the next step finishes it with the best coloring so far
+     */
+    void cancel();
+
+    /**
+     * @brief Returns if the job has finished 
+     */
+    bool isFinished();
+
+    /**
+     * @brief Returns the current progress, serializable with Progress::toJson()
+     */
+    Progress getProgress();
+
+    /**
+     * @brief Returns the result of a finished job 
+     */
+    SolverResult getResult();
+
+    /**
+     * @brief Returns the best coloring found, in compact form 
+     */
+    Snapshot *getBest();
+};
+
+class Solver
+{
+private:
+    // Algorithm parameters
+    SolverParameters parameters;
+
+    // Progress reporting
+    std::function<void(const Progress &)> progress_callback;
+
+    /**
+     * @brief Colors a graph with the search (a single run or the evolutionary
+     * search), then with the branch and bound when enabled
+     */
+    SolverResult solveSearch(Graph &graph, Snapshot *initial_coloring);
+
+    /**
+     * @brief Improves a result with the branch and bound, and proves it optimal
+     * if the search completes in time
+     */
+    void solveExact(Graph &graph, SolverResult &result);
+
+    /**
+     * @brief Colors a renumbered copy of a graph and maps the coloring back
+     */
+    SolverResult solveReordered(Graph &graph, Snapshot *initial_coloring);
+
+    /**
+     * @brief Colors a graph by searching its reduction, reducing again
+     * every time the number of colors improves
+     */
+    SolverResult solveReduced(Graph &graph, Snapshot *initial_coloring);
+
+    /**
+     * @brief Colors every connected component concurrently and merges
+     * the colorings, cliques and bipartite components are colored exactly
+     */
+    SolverResult solveComponents(Graph &graph, Snapshot *initial_coloring);
+
+    /**
+     * @brief Colors a graph with the hybrid evolutionary search
+     */
+    SolverResult solveEvolved(Graph &graph, Snapshot *initial_coloring);
+
+public:
+    /**
+     * @brief Solver constructor
+     * @param solver_parameters Algorithm parameters
+     */
+    Solver(SolverParameters solver_parameters = SolverParameters());
+
+    /**
+     * @brief Solver destructor 
+     */
+    ~Solver();
+
+    /**
+     * @brief Sets a function called with the progress after every temperature step
+     */
+    void setProgressCallback(std::function<void(const Progress &)> callback);
+
+    /**
+     * @brief Colors a graph
+     * @param graph The uncolored graph
+     * @param initial_coloring Valid coloring to start from instead of the greedy start (optional)
+     */
+    SolverResult solve(Graph &graph, Snapshot *initial_coloring = NULL);
+
+    /**
+     * @brief Colors a graph given as an edge array
+     * @param vertex_count Number of vertexes
+     * @param edges Pairs of different vertexes (numbered 0 through N-1), 2 * edge_count values
+     * @param edge_count Number of edges
+     */
+    SolverResult solveEdges(unsigned int vertex_count, const unsigned int *edges, unsigned int edge_count);
+
+    /**
+     * @brief Colors a graph given as a symmetric CSR adjacency structure
+     * @param vertex_count Number of vertexes
+     * @param offsets Row offsets, vertex_count + 1 values
+     * @param targets Adjacent vertexes of each row (numbered 0 through N-1), without the row's own vertex
+     */
+    SolverResult solveCsr(unsigned int vertex_count, const unsigned int *offsets, const unsigned int *targets);
+
+    /**
+     * @brief Creates a resumable job that colors a graph
+     * @param graph The uncolored graph
+     * @returns New job, owned by the caller
+     */
+    SolverJob *createJob(Graph &graph);
+};
+
+#endif // SOLVER_H
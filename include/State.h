@@ -8,85 +8,119 @@
 #include "Vertex.h"
 #include "Edge.h"
 #include "Color.h"
+#include "Index.h"
+#include "Instrumentation.h"
+#include "Snapshot.h"
+#include "Random.h"
 
-class State
+template <typename Index>
+class BasicState
 {
 private:
     // The graph
-    Graph G;
+    BasicGraph<Index> G;
 
-    // State value
+    // State value, the number of colors
     unsigned int value;
 
-    // Best state found
-    static State *best;
+    // Sum of the squared sizes of the color classes
+    unsigned long squared_sizes;
+
+    // Scratch buffers reused by the neighborhood operators, color marks are
+    // indexed by color and grow with the number of colors used
+    std::vector<unsigned int> color_marks;
+    std::vector<unsigned int> vertex_buffer;
+    std::vector<unsigned int> class_buffer;
+    unsigned int mark_stamp;
+
+    /**
+     * @brief Starts a new stamp, clearing the color marks when it wraps
+     */
+    void nextStamp();
 
 public:
     /**
      * @brief State constructor 
      * @param graph The state's graph containing vertex, edge and color information
      */
-    State(Graph graph);
+    BasicState(BasicGraph<Index> &graph);
+
+    /**
+     * @brief Copy constructor 
+     */
+    BasicState(BasicState &state);
 
     /**
      * @brief State destructor 
      */
-    ~State();
+    ~BasicState();
 
     /**
-     * @brief Computes state value
+     * @brief Computes state value, and the sum of squared class sizes
      * @returns The computed state value 
      */
     unsigned int computeValue();
 
+    /**
+     * @brief Turns this state into a copy of the given one, reusing
+     * the already allocated buffers
+     * @param state State being copied
+     */
+    void copyFrom(BasicState *state);
+
     /**
      * @brief Returns this state's value
      */
     unsigned int getValue();
 
     /**
-     * @brief Returns best found state 
+     * @brief Returns the sum of the squared sizes of the color classes
+     */
+    unsigned long getSquaredSizes();
+
+    /**
+     * @brief Builds a full state from a stored coloring
+     * @param graph The uncolored graph the coloring refers to
+     * @param snapshot The stored coloring
      */
-    static State *getBest();
+    static BasicState *fromSnapshot(BasicGraph<Index> &graph, Snapshot &snapshot);
 
     /**
-     * @brief Copies given state to best found state 
-     * @param state the new best sate
+     * @brief Returns this state's graph 
      */
-    static void setBest(State *state);
+    BasicGraph<Index> &getGraph();
 
-    // STARTING STATE AND NEIGHBORHOOD GENERATION
+    // STARTING STATE AND NEIGHBORHOOD MOVES
 
     /**
      * @brief Generates a starting state based on given graph 
+     * @param rng Random number generator of the run
      */
-    static State *generateStartingState(Graph graph);
+    static BasicState *generateStartingState(BasicGraph<Index> graph, Random &rng);
 
     /**
      * @brief Generates a starting state using a greedy
      * color selection strategy 
+     * @param rng Random number generator of the run
      */
-    static State *greedyStart(Graph graph);
-
-    /**
-     * @brief Generates a neighbor for this state
-     * @param iteration_number The current iteration
-     * @param temperature The current temperature, for dynamic neighbor generation 
-     */
-    State *generateNeighbor(unsigned int iteration_number, double temperature);
+    static BasicState *greedyStart(BasicGraph<Index> graph, Random &rng);
 
     /**
      * @brief Randomizes the color of n vertexes
      * in this state's graph 
      * @param n Amount of vertices being randomized
+     * @param rng Random number generator of the run
      */
-    void randomizeVertexColor(unsigned int n);
+    void randomizeVertexColor(unsigned int n, Random &rng);
 
     /**
-     * @brief Performs a local search to attempt
-     * to lower the number of colors used by one
+     * @brief Iterated Greedy (Culberson): orders the color classes in
+     * reverse, largest first or random order and recolors the vertexes
+     * first-fit, class after class. The number of colors never grows, in
+     * O(V + E)
+     * @param rng Random number generator of the run
      */
-    void localSearch();
+    void iteratedGreedy(Random &rng);
 
     // CHECKS AND INFORMATION
 
@@ -102,4 +136,7 @@ public:
     std::string toString();
 };
 
+// State of a graph with 32 bit ids, used outside of the search
+typedef BasicState<uint32_t> State;
+
 #endif // STATE_H
@@ -0,0 +1,59 @@
+/**
+ * Pool of pre-allocated states, used to recycle neighbors instead of
+ * freeing and allocating them on every iteration.
+ */
+#ifndef STATE_POOL_H
+#define STATE_POOL_H
+
+#include <vector>
+
+#include "State.h"
+
+template <typename Index>
+class BasicStatePool
+{
+private:
+    // Every state owned by the pool
+    std::vector<BasicState<Index> *> states;
+
+    // States that are available for use
+    std::vector<BasicState<Index> *> available;
+
+    // Number of states allocated after the pool was created
+    unsigned long extra_allocations;
+
+public:
+    /**
+     * @brief Creates a pool of copies of the given state
+     * @param prototype State whose buffers are used to size the pool's states
+     * @param capacity  Number of states allocated up front
+     */
+    BasicStatePool(BasicState<Index> *prototype, unsigned int capacity);
+
+    /**
+     * @brief Pool destructor, frees every state owned by the pool
+     */
+    ~BasicStatePool();
+
+    /**
+     * @brief Takes a state from the pool and makes it a copy of the given one
+     * @param source State being copied
+     * @returns Recycled state, only allocates if the pool is exhausted
+     */
+    BasicState<Index> *acquire(BasicState<Index> *source);
+
+    /**
+     * @brief Gives a state back to the pool
+     * @param state State acquired from this pool
+     */
+    void release(BasicState<Index> *state);
+
+    /**
+     * @brief Returns the number of states allocated because the pool was exhausted
+     */
+    unsigned long getExtraAllocations();
+};
+
+typedef BasicStatePool<uint32_t> StatePool;
+
+#endif // STATE_POOL_H
@@ -0,0 +1,142 @@
+/**
+ * Live telemetry of a run over a Unix domain socket.
+ *
+ * The run publishes every temperature step into a few counters guarded by
+ * a sequence lock: the writer makes the sequence odd, stores the fields and
+ * makes it even again, so it never waits for readers. A separate thread
+ * reads them (retrying while a write is in progress), serializes a snapshot
+ * in Prometheus text or JSON every interval and hands the latest one to
+ * every client that connects to the socket, raw or over HTTP, e.g.:
+ *
+ *   socat - UNIX-CONNECT:/tmp/coloring.sock
+ *   curl --unix-socket /tmp/coloring.sock http://localhost/metrics
+ */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "SimulatedAnnealing.h"
+
+// Snapshot formats
+enum TelemetryFormat
+{
+    TELEMETRY_PROMETHEUS, // Prometheus text exposition format
+    TELEMETRY_JSON        // Single line JSON object
+};
+
+// Consistent copy of the published counters
+struct TelemetrySample
+{
+    unsigned long steps;
+    unsigned long iteration;
+    double temperature;
+    unsigned int current_value;
+    unsigned int best_value;
+    unsigned long accepted;
+    unsigned long evaluated;
+    double run_seconds;
+    bool finished;
+};
+
+class Telemetry
+{
+private:
+    // Sequence lock, odd while a sample is written
+    std::atomic<unsigned long> sequence;
+
+    // Runs solved in parallel (components, batch jobs) take turns writing
+    std::atomic_flag writing;
+
+    // Published counters, relaxed atomics so that a read racing a write is
+    // only discarded; accepted and evaluated neighbors are totals
+    std::atomic<unsigned long> steps;
+    std::atomic<unsigned long> iteration;
+    std::atomic<double> temperature;
+    std::atomic<unsigned int> current_value;
+    std::atomic<unsigned int> best_value;
+    std::atomic<unsigned long> accepted;
+    std::atomic<unsigned long> evaluated;
+    std::atomic<double> run_seconds;
+    std::atomic<bool> finished;
+
+    // Socket, and its path
+    std::string path;
+    int server;
+
+    // Serialization thread, woken through the pipe to stop
+    std::thread worker;
+    int wake[2];
+
+    TelemetryFormat format;
+    double interval;
+    std::chrono::steady_clock::time_point start;
+
+    /**
+     * @brief Reads a consistent sample of the counters
+     */
+    TelemetrySample read();
+
+    /**
+     * @brief Serializes a sample with the rates since the previous one
+     */
+    std::string serialize(const TelemetrySample &sample, double acceptance_rate, double neighbors_per_second, double elapsed_seconds);
+
+    /**
+     * @brief Sends the snapshot to a client, with an HTTP header if it
+     * sent a request
+     */
+    void reply(int client, const std::string &snapshot);
+
+    /**
+     * @brief Serialization thread: refreshes the snapshot every interval
+     * and serves it until stopped
+     */
+    void serve();
+
+public:
+    /**
+     * @brief Opens the socket and starts the serialization thread
+     * @param socket_path Path of the socket, replaced if a stale one exists
+     * @param format_name prometheus or json
+     * @param refresh_seconds Interval between snapshots
+     */
+    Telemetry(std::string socket_path, std::string format_name = "prometheus", double refresh_seconds = 1);
+
+    /**
+     * @brief Stops the thread and removes the socket
+     */
+    ~Telemetry();
+
+    /**
+     * @brief Publishes a temperature step, called from the search
+     */
+    void record(const Progress &progress);
+
+    /**
+     * @brief Returns a progress callback that publishes every step
+     */
+    std::function<void(const Progress &)> callback();
+
+    /**
+     * @brief Returns the resident set size of the process, in bytes
+     */
+    static unsigned long residentBytes();
+};
+
+#endif // TELEMETRY_H
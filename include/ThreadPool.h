@@ -0,0 +1,69 @@
+/**
+ * Thread pool: the workers share one task queue guarded by a mutex, so
+ * tasks start in the order they were submitted. Tasks are coarse (whole
+ * runs), so the queue is never contended enough to need per-worker ones.
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+private:
+    // Worker threads
+    std::vector<std::thread> workers;
+
+    // Tasks not yet started, oldest first
+    std::deque<std::function<void()>> tasks;
+
+    // Tasks submitted and not yet finished
+    unsigned long pending;
+
+    // Guards the queue, the pending count and stopping
+    std::mutex lock;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    bool stopping;
+
+    /**
+     * @brief Worker loop
+     */
+    void work();
+
+public:
+    /**
+     * @brief Starts the pool
+     * @param thread_count Number of worker threads (0 uses every core)
+     */
+    ThreadPool(unsigned int thread_count = 0);
+
+    /**
+     * @brief Waits for every task and stops the workers
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Adds a task, tasks are started in submission order
+     * @param task The task
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task has finished
+     */
+    void wait();
+
+    /**
+     * @brief Returns the number of worker threads
+     */
+    unsigned int getThreadCount();
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,177 @@
+/**
+ * Parameter tuning by racing (F-race, Birattari et al.): candidate
+ * configurations of the search are run on a sequence of tasks, training
+ * instances each with a seed, all candidates on the same tasks. Once a few
+ * tasks are done, a Friedman test on the ranks of the candidates on every
+ * task decides whether they differ, and if so the ones whose rank sum is
+ * worse than the best one's by more than the critical difference are
+ * discarded. Evaluations of a round run in parallel on a thread pool, so
+ * the race goes on until one candidate is left, the tasks run out or the
+ * evaluation budget is spent.
+ *
+ * Candidates are ranked by the colors they use on each task, and the
+ * winner is the survivor with the best mean rank, the fastest one among
+ * equals. The parameters raced and their ranges are read from a space
+ * file with one "name minimum maximum [log]" line per parameter, the names
+ * being temperature, constant, cooling-factor, max-neighbors and
+ * max-iterations; parameters not listed keep the given value.
+ */
+#ifndef TUNER_H
+#define TUNER_H
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Batch.h"
+#include "Random.h"
+#include "Solver.h"
+#include "ThreadPool.h"
+
+// Range of a raced parameter
+struct TunedParameter
+{
+    std::string name;
+    double minimum;
+    double maximum;
+
+    // Sampled uniformly on a log scale
+    bool logarithmic;
+};
+
+// Configuration in the race, and its results on the tasks done
+struct Candidate
+{
+    SolverParameters parameters;
+    std::vector<unsigned int> colors;
+    std::vector<double> seconds;
+    bool alive;
+};
+
+class Tuner
+{
+private:
+    // Training instances, loaded once
+    std::vector<std::string> files;
+    std::vector<Graph *> graphs;
+
+    // Parameters of the search not raced, and the ranges of the raced ones
+    SolverParameters base;
+    std::vector<TunedParameter> space;
+
+    std::vector<Candidate> candidates;
+
+    // Tasks of the race: instance and seed offset, instances shuffled
+    std::vector<std::pair<unsigned int, unsigned int>> tasks;
+
+    // Number of worker threads (0 uses every core)
+    unsigned int thread_count;
+
+    // Seeds each instance is run with
+    unsigned int seed_count;
+
+    // Tasks before the first test, significance of the tests and maximum
+    // number of evaluations (0 for no limit)
+    unsigned int first_test;
+    double alpha;
+    unsigned long budget;
+    unsigned long evaluations;
+
+    Random rng;
+
+    /**
+     * @brief Draws the candidates, the given parameters being the first one
+     */
+    void sample(unsigned int count);
+
+    /**
+     * @brief Sets a parameter of a configuration by its name
+     */
+    static void setParameter(SolverParameters &parameters, std::string name, double value);
+
+    /**
+     * @brief Returns a parameter of a configuration by its name
+     */
+    static double getParameter(const SolverParameters &parameters, std::string name);
+
+    /**
+     * @brief Runs a candidate on a task and stores the result
+     */
+    void evaluate(unsigned int candidate, unsigned int task);
+
+    /**
+     * @brief Ranks the alive candidates on the first tasks, ties sharing
+     * their mean rank
+     * @param task_count Number of tasks ranked
+     * @param alive Indexes of the alive candidates
+     * @returns Ranks, one row per task
+     */
+    std::vector<std::vector<double>> rank(unsigned int task_count, const std::vector<unsigned int> &alive);
+
+    /**
+     * @brief Friedman test and post-hoc comparisons with the best
+     * candidate on the first tasks, discarding the worse ones
+     * @returns Number of candidates discarded
+     */
+    unsigned int test(unsigned int task_count);
+
+public:
+    /**
+     * @brief Tuner constructor
+     * @param parameters Parameters of the search, the first candidate
+     * @param threads Number of worker threads (0 uses every core)
+     */
+    Tuner(SolverParameters parameters, unsigned int threads = 0);
+
+    /**
+     * @brief Tuner destructor
+     */
+    ~Tuner();
+
+    /**
+     * @brief Adds the training instances listed by a path, see Batch::addInstances()
+     */
+    void addInstances(std::string path);
+
+    /**
+     * @brief Reads the parameters raced and their ranges, by default the
+     * temperature, constant, cooling factor and neighbors per iteration
+     */
+    void readSpace(std::string filename);
+
+    /**
+     * @brief Sets the race
+     * @param seeds Seeds each instance is run with
+     * @param first Tasks before the first test
+     * @param significance Significance level of the tests
+     * @param max_evaluations Maximum number of evaluations (0 for no limit)
+     */
+    void setRace(unsigned int seeds, unsigned int first, double significance, unsigned long max_evaluations);
+
+    /**
+     * @brief Races the candidates
+     * @param count Number of candidates
+     * @returns Parameters of the winner
+     */
+    SolverParameters run(unsigned int count);
+
+    /**
+     * @brief Writes the parameters of a configuration, one "name=value"
+     * line each, after a comment with the matching command line
+     */
+    void writeParameters(std::string filename, const SolverParameters &parameters);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the number of evaluations run
+     */
+    unsigned long getEvaluations();
+};
+
+#endif // TUNER_H
@@ -3,38 +3,41 @@
 
 #include <vector>
 
-#include "Color.h"
+#include "Index.h"
 
-class Color;
-
-class Vertex
+template <typename Index>
+class BasicVertex
 {
 private:
     // Vertex unique identifier
-    unsigned int id;
+    Index id;
 
     // Color assigned to vertex
-    unsigned int color;
+    Index color;
 
     // Vertexes that are adjacent to vertex
-    std::vector<unsigned int> adjacency_list;
+    std::vector<Index> adjacency_list;
+
+    // Neighbors in the list of users of this vertex's color
+    Index previous_user;
+    Index next_user;
 
 public:
     /**
      * @brief Vertex constructor
      */
-    Vertex(unsigned int vertex_id = -1, unsigned int color_id = -1);
+    BasicVertex(unsigned int vertex_id = -1, unsigned int color_id = -1);
 
     /**
      * @brief Class destructor 
      */
-    ~Vertex();
+    ~BasicVertex();
 
     /**
      * @brief Returns the adjacency list for this vertex 
      * @returns std::vector containing every vertex adjacent to this
      */
-    std::vector<unsigned int> getAdjacent();
+    const std::vector<Index> &getAdjacent();
 
     // SETTERS
 
@@ -43,6 +46,18 @@ public:
      */
     void setAdjacent(unsigned int vertex_id);
 
+    /**
+     * @brief Reserves room for a number of adjacent vertexes
+     */
+    void reserveAdjacent(unsigned int count);
+
+    /**
+     * @brief Removes one occurrence of an adjacent vertex, the order of the
+     * adjacency list is not kept
+     * @returns If the vertex was adjacent
+     */
+    bool removeAdjacent(unsigned int vertex_id);
+
     /**
      * @brief Labels this vertex with given id 
      */
@@ -54,6 +69,23 @@ public:
      */
     void setColor(unsigned int color_id);
 
+    /**
+     * @brief Links this vertex in the list of users of its color
+     * @param previous Previous user (or -1)
+     * @param next Next user (or -1)
+     */
+    void setUserLinks(unsigned int previous, unsigned int next);
+
+    /**
+     * @brief Sets the next user of this vertex's color
+     */
+    void setNextUser(unsigned int vertex_id);
+
+    /**
+     * @brief Sets the previous user of this vertex's color
+     */
+    void setPreviousUser(unsigned int vertex_id);
+
     // GETTERS
 
     /**
@@ -61,6 +93,16 @@ public:
      */
     unsigned int getColor();
 
+    /**
+     * @brief Returns the previous user of this vertex's color, or -1
+     */
+    unsigned int getPreviousUser();
+
+    /**
+     * @brief Returns the next user of this vertex's color, or -1
+     */
+    unsigned int getNextUser();
+
     /**
      * @brief Returns this vertex's identifier 
      */
@@ -76,4 +118,7 @@ public:
 
 };
 
+// Vertex with 32 bit ids, used outside of the search
+typedef BasicVertex<uint32_t> Vertex;
+
 #endif //VERTEX_H
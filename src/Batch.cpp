@@ -0,0 +1,263 @@
+#include "Batch.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <sstream>
+
+// Escapes a string for use inside JSON quotes
+static std::string escapeJson(std::string text)
+{
+    std::string escaped;
+
+    for (auto i = text.begin(); i != text.end(); ++i)
+    {
+        unsigned char c = *i;
+
+        if (c == '"' || c == '\\')
+        {
+            escaped.push_back('\\');
+            escaped.push_back(c);
+        }
+        else if (c == '\n')
+            escaped += "\\n";
+        else if (c == '\r')
+            escaped += "\\r";
+        else if (c == '\t')
+            escaped += "\\t";
+        else if (c < 0x20)
+        {
+            // Other control characters as \u00XX
+            char code[7];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        }
+        else
+            escaped.push_back(c);
+    }
+
+    return escaped;
+}
+
+Batch::Batch(SolverParameters solver_parameters, unsigned int threads)
+{
+    this->parameters = solver_parameters;
+    this->thread_count = threads;
+    this->cache = NULL;
+    this->target = 0;
+}
+
+Batch::~Batch()
+{
+    if (this->cache != NULL)
+        delete this->cache;
+}
+
+void Batch::setCache(std::string directory, unsigned int target_colors)
+{
+    if (this->cache != NULL)
+        delete this->cache;
+
+    this->cache = new SolutionCache(directory);
+    this->target = target_colors;
+}
+
+void Batch::addFile(std::string filename)
+{
+    this->files.push_back(filename);
+}
+
+void Batch::addInstances(std::string path)
+{
+    std::vector<std::string> found = Batch::listInstances(path);
+    this->files.insert(this->files.end(), found.begin(), found.end());
+}
+
+std::vector<std::string> Batch::listInstances(std::string path)
+{
+    std::vector<std::string> found;
+
+    if (std::filesystem::is_directory(path))
+    {
+        // Every graph file in the directory, sorted for a stable input order
+        for (auto &entry : std::filesystem::directory_iterator(path))
+            if (entry.is_regular_file() && GraphReader::isGraphFile(entry.path().string()))
+                found.push_back(entry.path().string());
+
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+
+    // Single instance
+    if (GraphReader::isGraphFile(path))
+    {
+        found.push_back(path);
+        return found;
+    }
+
+    // Manifest file
+    std::ifstream manifest(path);
+
+    if (!manifest.is_open())
+        throw std::runtime_error("Batch manifest does not exist!");
+
+    std::filesystem::path base = std::filesystem::path(path).parent_path();
+    std::string line;
+
+    while (std::getline(manifest, line))
+    {
+        // Trim whitespace
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+
+        // Ignore blank lines and comments
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::filesystem::path file(line);
+        found.push_back(file.is_absolute() ? line : (base / file).string());
+    }
+
+    return found;
+}
+
+unsigned int Batch::getInstanceCount()
+{
+    return this->files.size();
+}
+
+unsigned int Batch::run(std::string output_filename)
+{
+    std::atomic<unsigned int> failed(0);
+
+    this->output.open(output_filename);
+
+    if (!this->output.is_open())
+        throw std::runtime_error("Could not create batch output file!");
+
+    // Largest instances first, to reduce the tail of the batch
+    std::vector<unsigned int> order(this->files.size());
+    std::vector<uintmax_t> sizes(this->files.size(), 0);
+    std::iota(order.begin(), order.end(), 0);
+
+    for (unsigned int i = 0; i < this->files.size(); ++i)
+    {
+        std::error_code error;
+        sizes[i] = std::filesystem::file_size(this->files[i], error);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&sizes](unsigned int a, unsigned int b) { return sizes[a] > sizes[b]; });
+
+    // Load and solve every instance on the pool
+    {
+        ThreadPool pool(this->thread_count);
+
+        for (auto i = order.begin(); i != order.end(); ++i)
+        {
+            unsigned int index = *i;
+            pool.submit([this, index, &failed]() {
+                if (!this->solve(index))
+                    failed++;
+            });
+        }
+
+        pool.wait();
+    }
+
+    this->output.close();
+
+    return failed;
+}
+
+bool Batch::solve(unsigned int index)
+{
+    std::stringstream record;
+
+    record << "{\"index\": " << index
+           << ", \"file\": \"" << escapeJson(this->files[index]) << "\"";
+
+    try
+    {
+        // Load instance
+        Graph graph(this->files[index]);
+
+        // Own random stream for every instance
+        SolverParameters instance_parameters = this->parameters;
+        instance_parameters.stream = index;
+
+        // Instances already run in parallel, their components do not
+        instance_parameters.threads = 1;
+
+        // Best known coloring
+        Snapshot known;
+        bool cached = this->cache != NULL && this->cache->lookup(graph, known);
+
+        SolverResult result;
+
+        if (cached && SolutionCache::isSolved(graph, known, this->target))
+        {
+            // Nothing left to search
+            result.coloring.resize(known.getVertexCount());
+            for (unsigned int i = 0; i < known.getVertexCount(); ++i)
+                result.coloring[i] = known.getColor(i);
+
+            result.color_count = known.getValue();
+            result.correct = true;
+        }
+        else
+        {
+            Solver solver(instance_parameters);
+            result = solver.solve(graph, cached ? &known : NULL);
+
+            if (this->cache != NULL && result.correct)
+            {
+                Snapshot found;
+                found.assign(result.coloring);
+                this->cache->store(graph, found);
+            }
+
+            cached = false;
+        }
+
+        record << ", \"vertices\": " << graph.getVertexCount()
+               << ", \"edges\": " << graph.getEdgeCount()
+               << ", \"seed\": " << instance_parameters.seed
+               << ", \"stream\": " << instance_parameters.stream
+               << ", \"colors\": " << result.color_count
+               << ", \"correct\": " << (result.correct ? "true" : "false")
+               << ", \"optimal\": " << (result.optimal ? "true" : "false")
+               << ", \"cached\": " << (cached ? "true" : "false")
+               << ", \"iterations\": " << result.statistics.iterations
+               << ", \"removed_vertices\": " << result.statistics.removed_vertices
+               << ", \"components\": " << result.statistics.components
+               << ", \"seconds\": " << result.statistics.elapsed_seconds
+               << ", \"best_iteration\": " << result.statistics.best_iteration
+               << ", \"best_seconds\": " << result.statistics.best_seconds
+               << ", \"coloring\": [";
+
+        for (unsigned int i = 0; i < result.coloring.size(); ++i)
+            record << (i > 0 ? ", " : "") << result.coloring[i];
+
+        record << "]}";
+
+        this->write(record.str());
+
+        return result.correct;
+    }
+    catch (std::exception &e)
+    {
+        record << ", \"error\": \"" << escapeJson(e.what()) << "\"}";
+
+        this->write(record.str());
+
+        return false;
+    }
+}
+
+void Batch::write(std::string record)
+{
+    std::lock_guard<std::mutex> guard(this->output_lock);
+
+    this->output << record << std::endl;
+}
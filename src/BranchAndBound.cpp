@@ -0,0 +1,188 @@
+#include "BranchAndBound.h"
+
+BranchAndBound::BranchAndBound(Graph &graph)
+{
+    this->vertex_count = graph.getVertexCount();
+
+    this->offsets.assign(this->vertex_count + 1, 0);
+    for (unsigned int v = 0; v < this->vertex_count; ++v)
+    {
+        const std::vector<uint32_t> &adjacent = graph.getVertex(v)->getAdjacent();
+        this->offsets[v + 1] = this->offsets[v] + adjacent.size();
+        this->targets.insert(this->targets.end(), adjacent.begin(), adjacent.end());
+    }
+
+    this->lower_bound = graph.getCliqueLowerBound();
+
+    this->count_stride = 0;
+    this->words_per_vertex = 0;
+    this->color_limit = 0;
+    this->best_count = 0;
+    this->nodes = 0;
+}
+
+BranchAndBound::~BranchAndBound()
+{
+    // nil
+}
+
+void BranchAndBound::assign(unsigned int vertex, unsigned int color)
+{
+    this->colors[vertex] = color;
+
+    for (unsigned int i = this->offsets[vertex]; i < this->offsets[vertex + 1]; ++i)
+    {
+        unsigned int u = this->targets[i];
+        if (this->neighbor_counts[u * this->count_stride + color]++ == 0)
+        {
+            this->saturation[u * this->words_per_vertex + color / 64] |= (uint64_t)1 << (color % 64);
+            this->saturation_degree[u]++;
+        }
+    }
+}
+
+void BranchAndBound::unassign(unsigned int vertex)
+{
+    unsigned int color = this->colors[vertex];
+    this->colors[vertex] = -1;
+
+    for (unsigned int i = this->offsets[vertex]; i < this->offsets[vertex + 1]; ++i)
+    {
+        unsigned int u = this->targets[i];
+        if (--this->neighbor_counts[u * this->count_stride + color] == 0)
+        {
+            this->saturation[u * this->words_per_vertex + color / 64] &= ~((uint64_t)1 << (color % 64));
+            this->saturation_degree[u]--;
+        }
+    }
+}
+
+unsigned int BranchAndBound::select()
+{
+    unsigned int vertex = -1;
+
+    for (unsigned int v = 0; v < this->vertex_count; ++v)
+    {
+        if (this->colors[v] != (unsigned int)-1)
+            continue;
+
+        if (vertex == (unsigned int)-1 || this->saturation_degree[v] > this->saturation_degree[vertex] ||
+            (this->saturation_degree[v] == this->saturation_degree[vertex] &&
+             this->offsets[v + 1] - this->offsets[v] > this->offsets[vertex + 1] - this->offsets[vertex]))
+            vertex = v;
+    }
+
+    return vertex;
+}
+
+bool BranchAndBound::search()
+{
+    // Vertex colored at each depth, the next color to try for it, and the
+    // number of colors used above it
+    std::vector<unsigned int> vertex_at(this->vertex_count);
+    std::vector<unsigned int> next_color(this->vertex_count);
+    std::vector<unsigned int> used_at(this->vertex_count + 1);
+
+    unsigned int depth = 0;
+    used_at[0] = 0;
+    vertex_at[0] = this->select();
+    next_color[0] = 0;
+
+    while (true)
+    {
+        // Check the clock every few thousand nodes
+        if ((++this->nodes & 4095) == 0 && std::chrono::steady_clock::now() > this->deadline)
+            return false;
+
+        unsigned int vertex = vertex_at[depth];
+        unsigned int used = used_at[depth];
+
+        // Undo the previous try at this depth
+        if (this->colors[vertex] != (unsigned int)-1)
+            this->unassign(vertex);
+
+        // Next free used color, or a new one; colors are opened in order, so
+        // colorings that only differ by a renumbering are not searched twice
+        const uint64_t *saturated = &this->saturation[vertex * this->words_per_vertex];
+        unsigned int c = next_color[depth];
+        while (c < used && (saturated[c / 64] & ((uint64_t)1 << (c % 64))))
+            c++;
+
+        // Exhausted, or colors above it already use as many as the best coloring
+        if (c > used || c >= this->color_limit || used > this->color_limit)
+        {
+            if (depth == 0)
+                return true;
+
+            depth--;
+            continue;
+        }
+
+        next_color[depth] = c + 1;
+        this->assign(vertex, c);
+
+        used_at[depth + 1] = std::max(used, c + 1);
+
+        // Every vertex colored with fewer colors than the best coloring, now
+        // look for one color less, or stop at the lower bound
+        if (depth + 1 == this->vertex_count)
+        {
+            this->best = this->colors;
+            this->best_count = used_at[depth + 1];
+            this->color_limit = this->best_count - 1;
+
+            if (this->best_count <= this->lower_bound)
+                return true;
+
+            continue;
+        }
+
+        depth++;
+        vertex_at[depth] = this->select();
+        next_color[depth] = 0;
+    }
+}
+
+bool BranchAndBound::solve(Snapshot &coloring, double seconds)
+{
+    if (coloring.getVertexCount() != this->vertex_count)
+        throw std::runtime_error("Coloring does not match the graph!");
+
+    this->best_count = coloring.getValue();
+    this->best.resize(this->vertex_count);
+    for (unsigned int v = 0; v < this->vertex_count; ++v)
+        this->best[v] = coloring.getColor(v);
+
+    this->nodes = 0;
+
+    if (this->best_count <= this->lower_bound)
+        return true;
+
+    // Search for colorings with fewer colors, the limit drops with every one found
+    this->color_limit = this->best_count - 1;
+    this->count_stride = this->color_limit;
+    this->words_per_vertex = (this->color_limit + 63) / 64;
+
+    this->colors.assign(this->vertex_count, -1);
+    this->neighbor_counts.assign((unsigned long)this->vertex_count * this->count_stride, 0);
+    this->saturation.assign((unsigned long)this->vertex_count * this->words_per_vertex, 0);
+    this->saturation_degree.assign(this->vertex_count, 0);
+
+    this->deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+
+    bool complete = this->search();
+
+    coloring.assign(this->best);
+
+    return complete;
+}
+
+unsigned int BranchAndBound::getLowerBound()
+{
+    return this->lower_bound;
+}
+
+unsigned long BranchAndBound::getNodes()
+{
+    return this->nodes;
+}
@@ -0,0 +1,187 @@
+#include "Checkpoint.h"
+
+// Identifies checkpoint files and their layout
+static const char CHECKPOINT_MAGIC[4] = {'S', 'A', 'C', 'K'};
+static const uint32_t CHECKPOINT_VERSION = 3;
+
+/**
+ * @brief Writes a policy state, its length first
+ */
+static bool writeValues(FILE *file, const std::vector<double> &values)
+{
+    uint32_t count = values.size();
+
+    return fwrite(&count, sizeof(count), 1, file) == 1 &&
+           fwrite(values.data(), sizeof(double), count, file) == count;
+}
+
+/**
+ * @brief Reads a policy state written by writeValues()
+ */
+static bool readValues(FILE *file, std::vector<double> &values)
+{
+    uint32_t count;
+
+    if (fread(&count, sizeof(count), 1, file) != 1)
+        return false;
+
+    // A damaged length must not allocate more than the rest of the file
+    if (count > Snapshot::remainingBytes(file) / sizeof(double))
+        return false;
+
+    values.resize(count);
+
+    return fread(values.data(), sizeof(double), count, file) == count;
+}
+
+void Checkpoint::write(std::string filename)
+{
+    std::string temporary = filename + ".tmp";
+
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if (file == NULL)
+        throw std::runtime_error("Could not create checkpoint file!");
+
+    uint32_t sizes[2] = {this->vertex_count, this->edge_count};
+    uint64_t iteration = this->iteration_number;
+    double times[2] = {this->temperature, this->elapsed_seconds};
+
+    bool ok = fwrite(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC), 1, file) == 1 &&
+              fwrite(&CHECKPOINT_VERSION, sizeof(CHECKPOINT_VERSION), 1, file) == 1 &&
+              fwrite(sizes, sizeof(sizes), 1, file) == 1 &&
+              fwrite(&this->graph_hash, sizeof(this->graph_hash), 1, file) == 1 &&
+              fwrite(&iteration, sizeof(iteration), 1, file) == 1 &&
+              fwrite(times, sizeof(times), 1, file) == 1 &&
+              fwrite(this->rng_state, sizeof(this->rng_state), 1, file) == 1 &&
+              writeValues(file, this->acceptance_state) &&
+              writeValues(file, this->schedule_state) &&
+              this->current.write(file) &&
+              this->best.write(file);
+
+    // Make sure the data reaches the disk before replacing the old checkpoint
+    ok = fflush(file) == 0 && fsync(fileno(file)) == 0 && ok;
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok || rename(temporary.c_str(), filename.c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        throw std::runtime_error("Could not write checkpoint file!");
+    }
+}
+
+void Checkpoint::read(std::string filename)
+{
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file == NULL)
+        throw std::runtime_error("Checkpoint file does not exist!");
+
+    char magic[4];
+    uint32_t version;
+    uint32_t sizes[2];
+    uint64_t iteration;
+    double times[2];
+
+    bool ok = fread(magic, sizeof(magic), 1, file) == 1 &&
+              std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) == 0 &&
+              fread(&version, sizeof(version), 1, file) == 1 &&
+              version == CHECKPOINT_VERSION &&
+              fread(sizes, sizeof(sizes), 1, file) == 1 &&
+              fread(&this->graph_hash, sizeof(this->graph_hash), 1, file) == 1 &&
+              fread(&iteration, sizeof(iteration), 1, file) == 1 &&
+              fread(times, sizeof(times), 1, file) == 1 &&
+              fread(this->rng_state, sizeof(this->rng_state), 1, file) == 1 &&
+              readValues(file, this->acceptance_state) &&
+              readValues(file, this->schedule_state) &&
+              this->current.read(file, sizes[0]) &&
+              this->best.read(file, sizes[0]);
+
+    fclose(file);
+
+    if (!ok || !this->current.fits(sizes[0]) || !this->best.fits(sizes[0]))
+        throw std::runtime_error("Checkpoint file is not valid!");
+
+    this->vertex_count = sizes[0];
+    this->edge_count = sizes[1];
+    this->iteration_number = iteration;
+    this->temperature = times[0];
+    this->elapsed_seconds = times[1];
+}
+
+CheckpointWriter::CheckpointWriter(std::string filename, unsigned int vertexes) : filename(filename)
+{
+    this->staged.current.reserve(vertexes);
+    this->staged.best.reserve(vertexes);
+    this->writing.current.reserve(vertexes);
+    this->writing.best.reserve(vertexes);
+
+    this->pending = false;
+    this->stopping = false;
+
+    this->writer = std::thread(&CheckpointWriter::work, this);
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->changed.notify_all();
+
+    this->writer.join();
+}
+
+Checkpoint *CheckpointWriter::stage()
+{
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    // Skip this checkpoint instead of waiting for the disk
+    return this->pending ? NULL : &this->staged;
+}
+
+void CheckpointWriter::submit()
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->pending = true;
+    }
+    this->changed.notify_all();
+}
+
+void CheckpointWriter::work()
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    while (true)
+    {
+        this->changed.wait(guard, [this]() { return this->pending || this->stopping; });
+
+        if (!this->pending)
+            return;
+
+        // Swap buffers, the run can stage the next checkpoint meanwhile
+        std::swap(this->staged.vertex_count, this->writing.vertex_count);
+        std::swap(this->staged.edge_count, this->writing.edge_count);
+        std::swap(this->staged.graph_hash, this->writing.graph_hash);
+        std::swap(this->staged.iteration_number, this->writing.iteration_number);
+        std::swap(this->staged.temperature, this->writing.temperature);
+        std::swap(this->staged.elapsed_seconds, this->writing.elapsed_seconds);
+        std::swap(this->staged.rng_state, this->writing.rng_state);
+        this->staged.acceptance_state.swap(this->writing.acceptance_state);
+        this->staged.schedule_state.swap(this->writing.schedule_state);
+        this->staged.current.swap(this->writing.current);
+        this->staged.best.swap(this->writing.best);
+        this->pending = false;
+
+        guard.unlock();
+        try
+        {
+            this->writing.write(this->filename);
+        }
+        catch (std::exception &e)
+        {
+            std::cerr << "[ERROR]: " << e.what() << std::endl;
+        }
+        guard.lock();
+    }
+}
@@ -1,48 +1,84 @@
 #include "Color.h"
 
-Color::Color(unsigned int color_id)
+template <typename Index>
+BasicColor<Index>::BasicColor(unsigned int color_id)
 {
     this->id = color_id;
+    this->usage_counter = 0;
+    this->first_user = -1;
+    this->last_user = -1;
 }
 
-Color::~Color()
+template <typename Index>
+BasicColor<Index>::~BasicColor()
 {
     // nil
 }
 
-unsigned int Color::getId()
+template <typename Index>
+unsigned int BasicColor<Index>::getId()
 {
     return this->id;
 }
 
-std::vector<unsigned int> Color::getUsers()
+template <typename Index>
+unsigned int BasicColor<Index>::getFirstUser()
 {
-    return this->used_by;
+    return widenIndex(this->first_user);
 }
 
-unsigned int Color::getUsageCounter()
+template <typename Index>
+unsigned int BasicColor<Index>::getLastUser()
 {
-    return this->used_by.size();
+    return widenIndex(this->last_user);
 }
 
-void Color::setId(unsigned int color_id)
+template <typename Index>
+unsigned int BasicColor<Index>::getUsageCounter()
+{
+    return this->usage_counter;
+}
+
+template <typename Index>
+void BasicColor<Index>::setId(unsigned int color_id)
 {
     this->id = color_id;
 }
 
-void Color::addUser(unsigned int vertex)
+template <typename Index>
+void BasicColor<Index>::addUser(unsigned int vertex_id)
 {
-    this->used_by.push_back(vertex);
+    if (this->usage_counter == 0)
+        this->first_user = vertex_id;
+
+    this->last_user = vertex_id;
+    this->usage_counter++;
 }
 
-void Color::removeUser(unsigned int vertex)
+template <typename Index>
+void BasicColor<Index>::removeUser(unsigned int vertex_id, unsigned int previous_user, unsigned int next_user)
 {
-    for (auto i = this->used_by.begin(); i != this->used_by.end(); ++i)
-    {
-        if ((*i) == vertex)
-        {
-            this->used_by.erase(i);
-            return;
-        }
-    }
+    if (this->first_user == vertex_id)
+        this->first_user = next_user;
+
+    if (this->last_user == vertex_id)
+        this->last_user = previous_user;
+
+    this->usage_counter--;
 }
+
+template <typename Index>
+void BasicColor<Index>::takeUsers(BasicColor &color)
+{
+    this->first_user = color.first_user;
+    this->last_user = color.last_user;
+    this->usage_counter = color.usage_counter;
+
+    color.first_user = -1;
+    color.last_user = -1;
+    color.usage_counter = 0;
+}
+
+// Both index widths, see Index.h
+template class BasicColor<uint16_t>;
+template class BasicColor<uint32_t>;
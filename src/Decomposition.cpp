@@ -0,0 +1,153 @@
+#include "Decomposition.h"
+
+Decomposition::Decomposition(Graph &graph)
+{
+    unsigned int vertex_count = graph.getVertexCount();
+
+    // Union-find over every edge
+    std::vector<unsigned int> parent(vertex_count);
+    for (unsigned int u = 0; u < vertex_count; ++u)
+        parent[u] = u;
+
+    for (unsigned int u = 0; u < vertex_count; ++u)
+    {
+        const std::vector<unsigned int> &adjacent = graph.getVertex(u)->getAdjacent();
+        for (auto v = adjacent.begin(); v != adjacent.end(); ++v)
+        {
+            unsigned int a = find(parent, u);
+            unsigned int b = find(parent, *v);
+            if (a != b)
+                parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    // Group vertexes by root, keeping their original order
+    std::vector<unsigned int> component_of(vertex_count, -1);
+    std::vector<unsigned int> local_id(vertex_count);
+
+    for (unsigned int u = 0; u < vertex_count; ++u)
+    {
+        unsigned int root = find(parent, u);
+        if (component_of[root] == (unsigned int)-1)
+        {
+            component_of[root] = this->vertexes.size();
+            this->vertexes.push_back(std::vector<unsigned int>());
+        }
+
+        std::vector<unsigned int> &members = this->vertexes[component_of[root]];
+        local_id[u] = members.size();
+        members.push_back(u);
+    }
+
+    // Largest components first
+    std::stable_sort(this->vertexes.begin(), this->vertexes.end(),
+                     [](const std::vector<unsigned int> &a, const std::vector<unsigned int> &b) { return a.size() > b.size(); });
+
+    // Build a compact subgraph for every component
+    for (auto members = this->vertexes.begin(); members != this->vertexes.end(); ++members)
+    {
+        std::vector<unsigned int> edges;
+        for (auto u = members->begin(); u != members->end(); ++u)
+        {
+            const std::vector<unsigned int> &adjacent = graph.getVertex(*u)->getAdjacent();
+            for (auto v = adjacent.begin(); v != adjacent.end(); ++v)
+            {
+                if (*u < *v)
+                {
+                    edges.push_back(local_id[*u]);
+                    edges.push_back(local_id[*v]);
+                }
+            }
+        }
+
+        // Count distinct edges, input files may list an edge twice
+        std::vector<unsigned long> keys(edges.size() / 2);
+        for (unsigned long i = 0; i < keys.size(); ++i)
+            keys[i] = ((unsigned long)edges[2 * i] << 32) | edges[2 * i + 1];
+        std::sort(keys.begin(), keys.end());
+
+        this->edge_counts.push_back(std::unique(keys.begin(), keys.end()) - keys.begin());
+        this->components.push_back(new Graph(members->size(), edges.data(), edges.size() / 2));
+    }
+}
+
+Decomposition::~Decomposition()
+{
+    for (auto i = this->components.begin(); i != this->components.end(); ++i)
+        delete (*i);
+}
+
+unsigned int Decomposition::find(std::vector<unsigned int> &parent, unsigned int vertex)
+{
+    while (parent[vertex] != vertex)
+    {
+        parent[vertex] = parent[parent[vertex]];
+        vertex = parent[vertex];
+    }
+
+    return vertex;
+}
+
+unsigned int Decomposition::getComponentCount()
+{
+    return this->components.size();
+}
+
+Graph &Decomposition::getComponent(unsigned int component_id)
+{
+    return *this->components[component_id];
+}
+
+const std::vector<unsigned int> &Decomposition::getVertexes(unsigned int component_id)
+{
+    return this->vertexes[component_id];
+}
+
+unsigned long Decomposition::getEdgeCount(unsigned int component_id)
+{
+    return this->edge_counts[component_id];
+}
+
+ComponentKind Decomposition::classify(unsigned int component_id, std::vector<unsigned int> &coloring)
+{
+    Graph &component = *this->components[component_id];
+    unsigned long n = component.getVertexCount();
+
+    coloring.assign(n, -1);
+
+    // Every pair of vertexes is adjacent, one color each
+    if (this->edge_counts[component_id] == n * (n - 1) / 2 && n > 2)
+    {
+        for (unsigned int u = 0; u < n; ++u)
+            coloring[u] = u;
+
+        return COMPONENT_CLIQUE;
+    }
+
+    // Two-color the component with a breadth-first search
+    std::vector<unsigned int> queue;
+    queue.reserve(n);
+    queue.push_back(0);
+    coloring[0] = 0;
+
+    for (unsigned int head = 0; head < queue.size(); ++head)
+    {
+        unsigned int u = queue[head];
+        const std::vector<unsigned int> &adjacent = component.getVertex(u)->getAdjacent();
+
+        for (auto v = adjacent.begin(); v != adjacent.end(); ++v)
+        {
+            if (coloring[*v] == (unsigned int)-1)
+            {
+                coloring[*v] = 1 - coloring[u];
+                queue.push_back(*v);
+            }
+            else if (coloring[*v] == coloring[u])
+            {
+                return COMPONENT_GENERAL;
+            }
+        }
+    }
+
+    return COMPONENT_BIPARTITE;
+}
@@ -0,0 +1,445 @@
+#include "DynamicColoring.h"
+
+DynamicColoring::DynamicColoring(Graph &graph, SolverParameters solver_parameters) : G(graph)
+{
+    this->parameters = solver_parameters;
+
+    unsigned int vertex_count = this->G.getVertexCount();
+    this->colors.assign(vertex_count, -1);
+    this->positions.assign(vertex_count, 0);
+    this->color_marks.assign(vertex_count + 1, 0);
+    this->color_counts.assign(vertex_count + 1, 0);
+    this->mark_stamp = 0;
+    this->neighbor_marks.assign(vertex_count, 0);
+    this->visit_marks.assign(vertex_count, 0);
+    this->visit_stamp = 0;
+    this->chain.reserve(MAX_CHAIN + 1);
+
+    this->worker_running = false;
+    this->worker_done = false;
+    this->worker_graph = NULL;
+
+    // Initial coloring
+    Solver solver(this->parameters);
+    SolverResult result = solver.solve(this->G);
+    if (!result.correct)
+        throw std::runtime_error("Initial coloring is not valid!");
+
+    this->setColoring(result.coloring);
+    this->best_known = this->classes.size();
+}
+
+DynamicColoring::~DynamicColoring()
+{
+    if (this->worker_running)
+        this->worker.join();
+
+    if (this->worker_graph != NULL)
+        delete this->worker_graph;
+}
+
+void DynamicColoring::move(unsigned int vertex, unsigned int color)
+{
+    unsigned int old_color = this->colors[vertex];
+    if (old_color == color)
+        return;
+
+    // Swap the last vertex of the old color into its place
+    std::vector<unsigned int> &old_class = this->classes[old_color];
+    unsigned int last = old_class.back();
+    old_class[this->positions[vertex]] = last;
+    this->positions[last] = this->positions[vertex];
+    old_class.pop_back();
+
+    if (color == this->classes.size())
+        this->classes.emplace_back();
+
+    this->positions[vertex] = this->classes[color].size();
+    this->classes[color].push_back(vertex);
+    this->colors[vertex] = color;
+}
+
+void DynamicColoring::compact(unsigned int color)
+{
+    if (!this->classes[color].empty())
+        return;
+
+    unsigned int highest = this->classes.size() - 1;
+    if (color != highest)
+    {
+        this->classes[color].swap(this->classes[highest]);
+        for (auto i = this->classes[color].begin(); i != this->classes[color].end(); ++i)
+            this->colors[*i] = color;
+    }
+
+    this->classes.pop_back();
+}
+
+unsigned int DynamicColoring::markNeighbors(unsigned int vertex)
+{
+    this->mark_stamp++;
+
+    const std::vector<uint32_t> &adjacent = this->G.getVertex(vertex)->getAdjacent();
+    for (auto i = adjacent.begin(); i != adjacent.end(); ++i)
+    {
+        unsigned int color = this->colors[*i];
+        if (this->color_marks[color] != this->mark_stamp)
+        {
+            this->color_marks[color] = this->mark_stamp;
+            this->color_counts[color] = 0;
+        }
+        this->color_counts[color]++;
+    }
+
+    // At most deg + 1 colors are looked at
+    unsigned int k = this->classes.size();
+    unsigned int color = 0;
+    while (color < k && (this->color_marks[color] == this->mark_stamp || color == this->colors[vertex]))
+        color++;
+
+    return color;
+}
+
+unsigned int DynamicColoring::kempe(unsigned int vertex)
+{
+    unsigned int k = this->classes.size();
+    const std::vector<uint32_t> &adjacent = this->G.getVertex(vertex)->getAdjacent();
+
+    // Neighbors of the vertex, they must not be reached through color b
+    this->visit_stamp++;
+    unsigned int neighbor_stamp = this->visit_stamp;
+    for (auto i = adjacent.begin(); i != adjacent.end(); ++i)
+        this->neighbor_marks[*i] = neighbor_stamp;
+
+    unsigned int tries = 0;
+
+    // Colors used by one neighbor first, then by two
+    for (unsigned int limit = 1; limit <= 2; ++limit)
+    {
+        for (unsigned int a = 0; a < k; ++a)
+        {
+            if (this->color_counts[a] != limit || this->color_marks[a] != this->mark_stamp)
+                continue;
+
+            for (unsigned int b = 0; b < k; ++b)
+            {
+                if (b == a)
+                    continue;
+                if (tries++ == MAX_KEMPE_TRIES)
+                    return -1;
+
+                // Chain from the a-colored neighbors through colors a and b
+                this->visit_stamp++;
+                this->chain.clear();
+
+                for (auto i = adjacent.begin(); i != adjacent.end(); ++i)
+                {
+                    if (this->colors[*i] == a && this->visit_marks[*i] != this->visit_stamp)
+                    {
+                        this->visit_marks[*i] = this->visit_stamp;
+                        this->chain.push_back(*i);
+                    }
+                }
+
+                bool swappable = true;
+                for (unsigned int j = 0; swappable && j < this->chain.size(); ++j)
+                {
+                    const std::vector<uint32_t> &chain_adjacent = this->G.getVertex(this->chain[j])->getAdjacent();
+                    for (auto i = chain_adjacent.begin(); swappable && i != chain_adjacent.end(); ++i)
+                    {
+                        unsigned int color = this->colors[*i];
+                        if (*i == vertex || (color != a && color != b) || this->visit_marks[*i] == this->visit_stamp)
+                            continue;
+
+                        if ((color == b && this->neighbor_marks[*i] == neighbor_stamp) || this->chain.size() == MAX_CHAIN)
+                        {
+                            swappable = false;
+                        }
+                        else
+                        {
+                            this->visit_marks[*i] = this->visit_stamp;
+                            this->chain.push_back(*i);
+                        }
+                    }
+                }
+
+                if (!swappable)
+                    continue;
+
+                // Swap the chain, the vertex then takes a; colors a and b
+                // keep vertexes, only the vertex's old color may empty
+                for (auto i = this->chain.begin(); i != this->chain.end(); ++i)
+                    this->move(*i, this->colors[*i] == a ? b : a);
+
+                unsigned int old_color = this->colors[vertex];
+                this->move(vertex, a);
+                this->compact(old_color);
+
+                return this->colors[vertex];
+            }
+        }
+    }
+
+    return -1;
+}
+
+void DynamicColoring::repair(unsigned int vertex)
+{
+    unsigned int old_color = this->colors[vertex];
+    unsigned int color = this->markNeighbors(vertex);
+
+    if (color < this->classes.size())
+    {
+        this->move(vertex, color);
+        this->compact(old_color);
+        this->statistics.free_color_repairs++;
+    }
+    else if (this->kempe(vertex) != (unsigned int)-1)
+    {
+        this->statistics.kempe_repairs++;
+    }
+    else
+    {
+        this->move(vertex, this->classes.size());
+        this->compact(old_color);
+        this->statistics.new_color_repairs++;
+    }
+}
+
+void DynamicColoring::setColoring(const std::vector<unsigned int> &coloring)
+{
+    this->classes.clear();
+
+    for (unsigned int v = 0; v < coloring.size(); ++v)
+    {
+        if (coloring[v] >= this->classes.size())
+            this->classes.resize(coloring[v] + 1);
+
+        this->colors[v] = coloring[v];
+        this->positions[v] = this->classes[coloring[v]].size();
+        this->classes[coloring[v]].push_back(v);
+    }
+
+    // Colors skipped by the given coloring
+    for (unsigned int c = this->classes.size(); c > 0; --c)
+        this->compact(c - 1);
+}
+
+void DynamicColoring::collect()
+{
+    this->worker.join();
+    this->worker_running = false;
+    this->statistics.background_passes++;
+
+    // Apply the result, repair the edges inserted meanwhile, and keep it if it is still better
+    unsigned int current_count = this->classes.size();
+    if (this->worker_result.correct && this->worker_result.color_count < current_count)
+    {
+        std::vector<unsigned int> previous = this->colors;
+        DynamicStatistics counted = this->statistics;
+        this->setColoring(this->worker_result.coloring);
+
+        for (auto i = this->inserted_since.begin(); i != this->inserted_since.end(); ++i)
+        {
+            unsigned int first = (*i).first, second = (*i).second;
+            if (this->colors[first] == this->colors[second] && this->G.getVertex(first)->isAdjacentTo(second))
+            {
+                this->statistics.conflicts++;
+                this->repair(this->G.getVertex(first)->getAdjacent().size() < this->G.getVertex(second)->getAdjacent().size() ? first : second);
+            }
+        }
+
+        if (this->classes.size() < current_count)
+        {
+            this->statistics.background_improvements++;
+        }
+        else
+        {
+            this->setColoring(previous);
+            this->statistics = counted;
+        }
+    }
+
+    delete this->worker_graph;
+    this->worker_graph = NULL;
+    this->inserted_since.clear();
+
+    // The best known coloring of the current graph
+    this->best_known = this->classes.size();
+}
+
+void DynamicColoring::poll()
+{
+    if (this->worker_running && this->worker_done)
+        this->collect();
+
+    if (!this->worker_running && this->classes.size() > this->best_known)
+    {
+        // Solve a copy, every pass with its own stream
+        this->worker_graph = new Graph(this->G);
+        this->worker_coloring.assign(this->colors);
+
+        SolverParameters pass_parameters = this->parameters;
+        pass_parameters.stream = this->parameters.stream + this->statistics.background_passes + 1;
+
+        this->worker_done = false;
+        this->worker_running = true;
+        this->worker = std::thread([this, pass_parameters]() {
+            try
+            {
+                Solver solver(pass_parameters);
+                this->worker_result = solver.solve(*this->worker_graph, &this->worker_coloring);
+            }
+            catch (std::exception &e)
+            {
+                this->worker_result.correct = false;
+            }
+
+            this->worker_done = true;
+        });
+    }
+}
+
+void DynamicColoring::insertEdge(unsigned int first, unsigned int second)
+{
+    if (first >= this->colors.size() || second >= this->colors.size())
+        throw std::runtime_error("Edge update out of range!");
+
+    // Loops and edges already present change nothing
+    if (first == second || this->G.getVertex(first)->isAdjacentTo(second))
+        return;
+
+    this->G.addEdge(first, second);
+    this->statistics.insertions++;
+
+    if (this->worker_running)
+        this->inserted_since.push_back(std::make_pair(first, second));
+
+    // Recolor the endpoint with fewer neighbors
+    if (this->colors[first] == this->colors[second])
+    {
+        this->statistics.conflicts++;
+        this->repair(this->G.getVertex(first)->getAdjacent().size() < this->G.getVertex(second)->getAdjacent().size() ? first : second);
+    }
+
+    this->poll();
+}
+
+void DynamicColoring::removeEdge(unsigned int first, unsigned int second)
+{
+    if (first >= this->colors.size() || second >= this->colors.size())
+        throw std::runtime_error("Edge update out of range!");
+
+    if (first == second || !this->G.removeEdge(first, second))
+        return;
+
+    this->statistics.removals++;
+
+    // An endpoint alone in its color may now fit in another one
+    unsigned int endpoints[2] = {first, second};
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        unsigned int vertex = endpoints[i];
+        unsigned int old_color = this->colors[vertex];
+
+        if (this->classes[old_color].size() != 1)
+            continue;
+
+        unsigned int color = this->markNeighbors(vertex);
+        if (color < this->classes.size())
+        {
+            this->move(vertex, color);
+            this->compact(old_color);
+            this->statistics.removal_improvements++;
+        }
+    }
+
+    this->poll();
+}
+
+void DynamicColoring::apply(const EdgeUpdate &update)
+{
+    if (update.insert)
+        this->insertEdge(update.first, update.second);
+    else
+        this->removeEdge(update.first, update.second);
+}
+
+void DynamicColoring::finish()
+{
+    if (this->worker_running)
+        this->collect();
+}
+
+bool DynamicColoring::readUpdate(std::istream &stream, bool binary, EdgeUpdate &update)
+{
+    unsigned long first = 0, second = 0;
+
+    if (binary)
+    {
+        unsigned char record[12];
+        stream.read((char *)record, sizeof(record));
+
+        if (stream.gcount() == 0)
+            return false;
+        if (stream.gcount() != sizeof(record))
+            throw std::runtime_error("Truncated update stream!");
+
+        uint32_t values[3];
+        for (unsigned int i = 0; i < 3; ++i)
+            values[i] = record[4 * i] | record[4 * i + 1] << 8 | record[4 * i + 2] << 16 | (uint32_t)record[4 * i + 3] << 24;
+
+        if (values[0] > 1)
+            throw std::runtime_error("Invalid update operation!");
+
+        update.insert = values[0] == 1;
+        first = values[1];
+        second = values[2];
+    }
+    else
+    {
+        std::string line;
+        char operation = 0;
+
+        // Skip comments and blank lines
+        do
+        {
+            if (!std::getline(stream, line))
+                return false;
+        } while (line.empty() || line[0] == 'c' || line[0] == '#');
+
+        std::istringstream fields(line);
+        if (!(fields >> operation >> first >> second) || (operation != '+' && operation != '-' && operation != 'e'))
+            throw std::runtime_error("Invalid update line '" + line + "'!");
+
+        update.insert = operation != '-';
+    }
+
+    if (first == 0 || second == 0)
+        throw std::runtime_error("Vertexes are numbered from 1!");
+
+    update.first = first - 1;
+    update.second = second - 1;
+
+    return true;
+}
+
+unsigned int DynamicColoring::getColorCount()
+{
+    return this->classes.size();
+}
+
+const std::vector<unsigned int> &DynamicColoring::getColoring()
+{
+    return this->colors;
+}
+
+Graph &DynamicColoring::getGraph()
+{
+    return this->G;
+}
+
+DynamicStatistics DynamicColoring::getStatistics()
+{
+    return this->statistics;
+}
@@ -0,0 +1,60 @@
+#include "ElitePool.h"
+
+ElitePool::ElitePool(unsigned int capacity, unsigned int vertex_count) : elite(capacity)
+{
+    this->size = 0;
+
+    // Allocate every buffer up front
+    for (auto i = this->elite.begin(); i != this->elite.end(); ++i)
+        (*i).reserve(vertex_count);
+    this->candidate.reserve(vertex_count);
+}
+
+ElitePool::~ElitePool()
+{
+    // nil
+}
+
+bool ElitePool::accepts(unsigned int value)
+{
+    return this->elite.size() > 0 &&
+           (this->size < this->elite.size() || value < this->elite[this->size - 1].getValue());
+}
+
+template <typename Index>
+bool ElitePool::offer(BasicGraph<Index> &graph, unsigned int value)
+{
+    if (!this->accepts(value))
+        return false;
+
+    this->candidate.capture(graph, value);
+
+    // Ignore colorings that are already stored
+    for (unsigned int i = 0; i < this->size; ++i)
+        if (this->elite[i].getValue() == value && this->elite[i].sameColoring(this->candidate))
+            return false;
+
+    // Take a free slot, or replace the worst snapshot
+    unsigned int i = this->size < this->elite.size() ? this->size++ : this->size - 1;
+    this->elite[i].swap(this->candidate);
+
+    // Move it to its sorted position
+    for (; i > 0 && this->elite[i].getValue() < this->elite[i - 1].getValue(); --i)
+        this->elite[i].swap(this->elite[i - 1]);
+
+    return true;
+}
+
+unsigned int ElitePool::getSize()
+{
+    return this->size;
+}
+
+Snapshot *ElitePool::get(unsigned int i)
+{
+    return &this->elite[i];
+}
+
+// Both index widths, see Index.h
+template bool ElitePool::offer(BasicGraph<uint16_t> &graph, unsigned int value);
+template bool ElitePool::offer(BasicGraph<uint32_t> &graph, unsigned int value);
@@ -0,0 +1,321 @@
+#include "Evolution.h"
+
+Evolution::Evolution(Graph &graph, Random random, Kernel kernel, unsigned int threads) : G(graph), rng(random)
+{
+    this->kernel = kernel;
+    this->threads = threads;
+    this->iterations = 0;
+    this->best_iteration = 0;
+    this->best_seconds = 0;
+}
+
+Evolution::~Evolution()
+{
+    // nil
+}
+
+unsigned long Evolution::improve(Snapshot &coloring, Random random)
+{
+    SimulatedAnnealing *algorithm = this->kernel(random);
+    algorithm->setInitialColoring(coloring);
+    algorithm->run();
+
+    coloring.copyFrom(*algorithm->getBest());
+    unsigned long run_iterations = algorithm->getIterations();
+
+    delete algorithm;
+
+    return run_iterations;
+}
+
+void Evolution::run(unsigned int size, unsigned int generations, Snapshot *initial_coloring)
+{
+    size = std::max(size, 2u);
+    this->start = std::chrono::steady_clock::now();
+
+    ThreadPool pool(this->threads);
+    unsigned int batch = pool.getThreadCount();
+
+    // Colorings built concurrently, with their generators drawn in order so
+    // that the result does not depend on the scheduling
+    std::vector<Snapshot> offspring(std::max(size, batch));
+    std::vector<uint64_t> seeds(offspring.size());
+    std::vector<unsigned long> run_iterations(offspring.size());
+
+    // Initial population: greedy starts, or the given coloring, improved
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        seeds[i] = this->rng.next64();
+        pool.submit([this, &offspring, &seeds, &run_iterations, initial_coloring, i]() {
+            Random random(seeds[i]);
+
+            if (i == 0 && initial_coloring != NULL)
+            {
+                offspring[i].copyFrom(*initial_coloring);
+            }
+            else
+            {
+                State *starting_state = State::generateStartingState(this->G, random);
+                offspring[i].capture(starting_state->getGraph(), starting_state->getValue());
+                delete starting_state;
+            }
+
+            run_iterations[i] = this->improve(offspring[i], random);
+        });
+    }
+    pool.wait();
+
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        this->iterations += run_iterations[i];
+        this->insert(offspring[i], size);
+    }
+
+    // Every generation crosses one pair of random members per thread
+    std::vector<std::pair<unsigned int, unsigned int>> parents(batch);
+
+    for (unsigned int generation = 0; generation < generations; ++generation)
+    {
+        for (unsigned int i = 0; i < batch; ++i)
+        {
+            unsigned int first = this->rng.next() % this->population.size();
+            unsigned int second = (first + 1 + this->rng.next() % (this->population.size() - 1)) % this->population.size();
+            parents[i] = std::make_pair(first, second);
+            seeds[i] = this->rng.next64();
+
+            pool.submit([this, &offspring, &seeds, &run_iterations, &parents, i]() {
+                Random random(seeds[i]);
+
+                Evolution::crossover(this->G, this->population[parents[i].first], this->population[parents[i].second], offspring[i], random);
+                run_iterations[i] = this->improve(offspring[i], random);
+            });
+        }
+        pool.wait();
+
+        for (unsigned int i = 0; i < batch; ++i)
+        {
+            this->iterations += run_iterations[i];
+            this->insert(offspring[i], size);
+        }
+    }
+}
+
+void Evolution::insert(Snapshot &coloring, unsigned int size)
+{
+    // Distances between the new member and the others
+    unsigned int n = this->population.size();
+    std::vector<unsigned int> row(n + 1, 0);
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        row[i] = Evolution::distance(this->population[i], coloring);
+        this->distances[i].push_back(row[i]);
+    }
+    this->distances.push_back(row);
+
+    this->population.emplace_back();
+    this->population.back().swap(coloring);
+
+    if (this->best.getVertexCount() == 0 || this->population.back().getValue() < this->best.getValue())
+    {
+        this->best.copyFrom(this->population.back());
+        this->best_iteration = this->iterations;
+        this->best_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->start).count();
+    }
+
+    if (this->population.size() <= size)
+        return;
+
+    // Value range, and distance of each member to the closest other one
+    n = this->population.size();
+    unsigned int lowest_value = -1, highest_value = 0;
+    unsigned int closest_min = -1, closest_max = 0;
+    unsigned int protected_member = 0;
+    std::vector<unsigned int> closest(n, -1);
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        unsigned int value = this->population[i].getValue();
+        if (value < lowest_value)
+        {
+            lowest_value = value;
+            protected_member = i;
+        }
+        highest_value = std::max(highest_value, value);
+
+        for (unsigned int j = 0; j < n; ++j)
+            if (j != i)
+                closest[i] = std::min(closest[i], this->distances[i][j]);
+
+        closest_min = std::min(closest_min, closest[i]);
+        closest_max = std::max(closest_max, closest[i]);
+    }
+
+    // Drop the member with the lowest score, good values and far members score high
+    unsigned int dropped = -1;
+    double lowest_score = 0;
+
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        if (i == protected_member)
+            continue;
+
+        double score = VALUE_WEIGHT * (highest_value - this->population[i].getValue()) / (highest_value - lowest_value + 1) +
+                       (1 - VALUE_WEIGHT) * (closest[i] - closest_min) / (closest_max - closest_min + 1);
+
+        if (dropped == (unsigned int)-1 || score < lowest_score)
+        {
+            dropped = i;
+            lowest_score = score;
+        }
+    }
+
+    // Move the dropped member to the end and remove it
+    unsigned int last = n - 1;
+    this->population[dropped].swap(this->population[last]);
+    this->distances[dropped].swap(this->distances[last]);
+    for (unsigned int i = 0; i < n; ++i)
+        std::swap(this->distances[i][dropped], this->distances[i][last]);
+
+    this->population.pop_back();
+    this->distances.pop_back();
+    for (unsigned int i = 0; i < last; ++i)
+        this->distances[i].pop_back();
+}
+
+void Evolution::crossover(Graph &graph, Snapshot &first, Snapshot &second, Snapshot &offspring, Random &random)
+{
+    unsigned int vertex_count = graph.getVertexCount();
+    Snapshot *parent[2] = {&first, &second};
+
+    // Vertexes of each class of each parent, grouped by class, and the
+    // number of them not yet taken by the offspring
+    std::vector<unsigned int> members[2], offsets[2], remaining[2];
+
+    for (unsigned int p = 0; p < 2; ++p)
+    {
+        unsigned int k = parent[p]->getValue();
+
+        remaining[p].assign(k, 0);
+        for (unsigned int v = 0; v < vertex_count; ++v)
+            remaining[p][parent[p]->getColor(v)]++;
+
+        offsets[p].assign(k + 1, 0);
+        for (unsigned int c = 0; c < k; ++c)
+            offsets[p][c + 1] = offsets[p][c] + remaining[p][c];
+
+        std::vector<unsigned int> position(offsets[p].begin(), offsets[p].end() - 1);
+        members[p].resize(vertex_count);
+        for (unsigned int v = 0; v < vertex_count; ++v)
+            members[p][position[parent[p]->getColor(v)]++] = v;
+    }
+
+    // Take the largest remaining class of each parent in turn
+    std::vector<unsigned int> coloring(vertex_count, -1);
+    unsigned int classes = std::max(std::min(first.getValue(), second.getValue()), 1u) - 1;
+
+    for (unsigned int l = 0; l < classes; ++l)
+    {
+        unsigned int p = l % 2;
+        unsigned int c = std::max_element(remaining[p].begin(), remaining[p].end()) - remaining[p].begin();
+
+        if (remaining[p][c] == 0)
+            break;
+
+        for (unsigned int i = offsets[p][c]; i < offsets[p][c + 1]; ++i)
+        {
+            unsigned int v = members[p][i];
+            if (coloring[v] == (unsigned int)-1)
+            {
+                coloring[v] = l;
+                remaining[1 - p][parent[1 - p]->getColor(v)]--;
+            }
+        }
+
+        remaining[p][c] = 0;
+    }
+
+    // Remaining vertexes in random order, each with the first free color
+    std::vector<unsigned int> &left = members[0];
+    left.clear();
+    for (unsigned int v = 0; v < vertex_count; ++v)
+        if (coloring[v] == (unsigned int)-1)
+            left.push_back(v);
+
+    for (unsigned int i = left.size(); i > 1; --i)
+        std::swap(left[i - 1], left[random.next() % i]);
+
+    std::vector<unsigned int> marks(vertex_count + 1, -1);
+    for (auto i = left.begin(); i != left.end(); ++i)
+    {
+        const std::vector<uint32_t> &adjacency = graph.getVertex(*i)->getAdjacent();
+        for (auto j = adjacency.begin(); j != adjacency.end(); ++j)
+            if (coloring[*j] != (unsigned int)-1)
+                marks[coloring[*j]] = *i;
+
+        unsigned int color = 0;
+        while (marks[color] == *i)
+            color++;
+        coloring[*i] = color;
+    }
+
+    offspring.assign(coloring);
+}
+
+unsigned int Evolution::distance(Snapshot &first, Snapshot &second)
+{
+    unsigned int vertex_count = first.getVertexCount();
+    unsigned long k = second.getValue();
+
+    // Pair of classes of every vertex, sorted so that equal pairs are together
+    std::vector<unsigned long> pairs(vertex_count);
+    for (unsigned int v = 0; v < vertex_count; ++v)
+        pairs[v] = first.getColor(v) * k + second.getColor(v);
+    std::sort(pairs.begin(), pairs.end());
+
+    // Overlap of every two classes that share vertexes, largest first
+    std::vector<std::pair<unsigned int, unsigned long>> overlaps;
+    for (unsigned int i = 0, j; i < vertex_count; i = j)
+    {
+        for (j = i + 1; j < vertex_count && pairs[j] == pairs[i]; ++j)
+            ;
+        overlaps.push_back(std::make_pair(j - i, pairs[i]));
+    }
+    std::sort(overlaps.begin(), overlaps.end(), std::greater<std::pair<unsigned int, unsigned long>>());
+
+    // Match the classes greedily, matched vertexes keep their class
+    std::vector<bool> matched_first(first.getValue(), false), matched_second(k, false);
+    unsigned int kept = 0;
+
+    for (auto i = overlaps.begin(); i != overlaps.end(); ++i)
+    {
+        unsigned int a = (*i).second / k, b = (*i).second % k;
+        if (!matched_first[a] && !matched_second[b])
+        {
+            matched_first[a] = true;
+            matched_second[b] = true;
+            kept += (*i).first;
+        }
+    }
+
+    return vertex_count - kept;
+}
+
+Snapshot *Evolution::getBest()
+{
+    return &this->best;
+}
+
+unsigned long Evolution::getIterations()
+{
+    return this->iterations;
+}
+
+unsigned long Evolution::getBestIteration()
+{
+    return this->best_iteration;
+}
+
+double Evolution::getBestSeconds()
+{
+    return this->best_seconds;
+}
@@ -0,0 +1,387 @@
+#include "Generator.h"
+
+Generator::Generator(uint64_t seed) : rng(seed)
+{
+    this->vertex_count = 0;
+}
+
+Generator::~Generator()
+{
+    // nil
+}
+
+void Generator::addEdge(unsigned int first, unsigned int second)
+{
+    if (first == second)
+        return;
+
+    this->edges.push_back(std::min(first, second));
+    this->edges.push_back(std::max(first, second));
+}
+
+void Generator::normalize()
+{
+    std::vector<uint64_t> keys(this->edges.size() / 2);
+    for (unsigned long i = 0; i < keys.size(); ++i)
+        keys[i] = (uint64_t)this->edges[2 * i] << 32 | this->edges[2 * i + 1];
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    this->edges.resize(2 * keys.size());
+    for (unsigned long i = 0; i < keys.size(); ++i)
+    {
+        this->edges[2 * i] = keys[i] >> 32;
+        this->edges[2 * i + 1] = keys[i] & 0xFFFFFFFF;
+    }
+}
+
+unsigned long Generator::skip(double p)
+{
+    if (p >= 1)
+        return 0;
+
+    double failures = std::floor(std::log1p(-this->rng.uniform()) / std::log1p(-p));
+
+    return failures < 1e18 ? (unsigned long)failures : (unsigned long)1e18;
+}
+
+void Generator::partition(unsigned int k, std::vector<std::vector<unsigned int>> &classes)
+{
+    std::vector<unsigned int> order(this->vertex_count);
+    for (unsigned int i = 0; i < this->vertex_count; ++i)
+        order[i] = i;
+
+    for (unsigned int i = this->vertex_count; i > 1; --i)
+        std::swap(order[i - 1], order[this->rng.next64() % i]);
+
+    classes.assign(k, std::vector<unsigned int>());
+    for (unsigned int i = 0; i < this->vertex_count; ++i)
+        classes[i % k].push_back(order[i]);
+}
+
+void Generator::random(unsigned int n, double p)
+{
+    if (p < 0 || p > 1)
+        throw std::runtime_error("Edge probability must be between 0 and 1!");
+
+    this->vertex_count = n;
+    this->edges.clear();
+
+    if (p == 0)
+        return;
+
+    // Batagelj and Brandes: skip over the pairs (v, w), w < v, that get no edge
+    long long v = 1, w = -1;
+    while (v < n)
+    {
+        w += 1 + this->skip(p);
+        while (w >= v && v < n)
+        {
+            w -= v;
+            v++;
+        }
+
+        if (v < n)
+            this->addEdge(v, w);
+    }
+
+    this->normalize();
+}
+
+void Generator::queen(unsigned int n)
+{
+    this->vertex_count = n * n;
+    this->edges.clear();
+
+    // Every attacking pair shares exactly one row, column or diagonal
+    std::vector<unsigned int> line;
+    auto connect = [this, &line]() {
+        for (unsigned int i = 0; i < line.size(); ++i)
+            for (unsigned int j = i + 1; j < line.size(); ++j)
+                this->addEdge(line[i], line[j]);
+    };
+
+    for (unsigned int r = 0; r < n; ++r)
+    {
+        line.clear();
+        for (unsigned int c = 0; c < n; ++c)
+            line.push_back(r * n + c);
+        connect();
+    }
+
+    for (unsigned int c = 0; c < n; ++c)
+    {
+        line.clear();
+        for (unsigned int r = 0; r < n; ++r)
+            line.push_back(r * n + c);
+        connect();
+    }
+
+    for (unsigned int d = 0; n > 0 && d < 2 * n - 1; ++d)
+    {
+        // Diagonal r - c = d - (n - 1)
+        line.clear();
+        for (unsigned int r = 0; r < n; ++r)
+        {
+            long long c = (long long)r - ((long long)d - (n - 1));
+            if (c >= 0 && c < n)
+                line.push_back(r * n + c);
+        }
+        connect();
+
+        // Anti-diagonal r + c = d
+        line.clear();
+        for (unsigned int r = 0; r < n; ++r)
+        {
+            long long c = (long long)d - r;
+            if (c >= 0 && c < n)
+                line.push_back(r * n + c);
+        }
+        connect();
+    }
+
+    this->normalize();
+}
+
+void Generator::flat(unsigned int n, unsigned int k, double p)
+{
+    if (k == 0 || k > n)
+        throw std::runtime_error("Hidden colors must be between 1 and the number of vertexes!");
+    if (p < 0 || p > 1)
+        throw std::runtime_error("Edge probability must be between 0 and 1!");
+
+    this->vertex_count = n;
+    this->edges.clear();
+
+    std::vector<std::vector<unsigned int>> classes;
+    this->partition(k, classes);
+
+    // The same share of the pairs of every two classes, sampled without
+    // repetition; above one half the pairs left out are sampled instead
+    std::unordered_set<uint64_t> chosen;
+    for (unsigned int a = 0; a < k; ++a)
+    {
+        for (unsigned int b = a + 1; b < k; ++b)
+        {
+            uint64_t columns = classes[b].size();
+            uint64_t pairs = classes[a].size() * columns;
+            uint64_t target = std::llround(p * pairs);
+            bool complement = target > pairs / 2;
+
+            chosen.clear();
+            uint64_t count = complement ? pairs - target : target;
+            while (chosen.size() < count)
+                chosen.insert(this->rng.next64() % pairs);
+
+            if (complement)
+            {
+                for (uint64_t i = 0; i < pairs; ++i)
+                    if (chosen.count(i) == 0)
+                        this->addEdge(classes[a][i / columns], classes[b][i % columns]);
+            }
+            else
+            {
+                for (auto i = chosen.begin(); i != chosen.end(); ++i)
+                    this->addEdge(classes[a][*i / columns], classes[b][*i % columns]);
+            }
+        }
+    }
+
+    this->normalize();
+}
+
+void Generator::leighton(unsigned int n, unsigned int k, unsigned long m)
+{
+    if (k < 2 || k > n)
+        throw std::runtime_error("Hidden colors must be between 2 and the number of vertexes!");
+
+    this->vertex_count = n;
+    this->edges.clear();
+
+    std::vector<std::vector<unsigned int>> classes;
+    this->partition(k, classes);
+
+    // Pairs of vertexes in different classes
+    uint64_t available = (uint64_t)n * n;
+    for (unsigned int c = 0; c < k; ++c)
+        available -= (uint64_t)classes[c].size() * classes[c].size();
+    if (m > available / 2)
+        throw std::runtime_error("Too many edges for the hidden coloring!");
+
+    std::vector<unsigned int> class_order(k);
+    for (unsigned int c = 0; c < k; ++c)
+        class_order[c] = c;
+
+    std::vector<unsigned int> clique;
+    unsigned int size = k;
+
+    while (true)
+    {
+        while (this->edges.size() / 2 < m)
+        {
+            // One vertex of each of size distinct classes
+            clique.clear();
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                std::swap(class_order[i], class_order[i + this->rng.next64() % (k - i)]);
+                const std::vector<unsigned int> &members = classes[class_order[i]];
+                clique.push_back(members[this->rng.next64() % members.size()]);
+            }
+
+            for (unsigned int i = 0; i < size; ++i)
+                for (unsigned int j = i + 1; j < size; ++j)
+                    this->addEdge(clique[i], clique[j]);
+
+            size = 2 + this->rng.next64() % (k - 1);
+        }
+
+        // Cliques overlap, count again without the repeated edges
+        this->normalize();
+        if (this->edges.size() / 2 >= m)
+            break;
+    }
+}
+
+void Generator::chungLu(unsigned int n, double average_degree, double exponent)
+{
+    if (exponent <= 1)
+        throw std::runtime_error("Power law exponent must be above 1!");
+    if (average_degree <= 0 || average_degree >= n)
+        throw std::runtime_error("Average degree must be between 0 and the number of vertexes!");
+
+    this->vertex_count = n;
+    this->edges.clear();
+
+    // Expected degrees, decreasing, scaled to the average degree
+    std::vector<double> weights(n);
+    double sum = 0;
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        weights[i] = std::pow(i + 1.0, -1.0 / (exponent - 1));
+        sum += weights[i];
+    }
+
+    double total = average_degree * n;
+    for (unsigned int i = 0; i < n; ++i)
+        weights[i] *= total / sum;
+
+    // Miller and Hagberg: edge (u, v) has probability w_u w_v / total, and
+    // the probability only drops along v, so pairs are skipped geometrically
+    // with the current one and accepted with the ratio to the real one
+    for (unsigned int u = 0; u + 1 < n; ++u)
+    {
+        unsigned long v = u + 1;
+        double p = std::min(weights[u] * weights[v] / total, 1.0);
+
+        while (v < n && p > 0)
+        {
+            if (p < 1)
+                v += this->skip(p);
+
+            if (v < n)
+            {
+                double q = std::min(weights[u] * weights[v] / total, 1.0);
+                if (this->rng.uniform() < q / p)
+                    this->addEdge(u, v);
+
+                p = q;
+                v++;
+            }
+        }
+    }
+
+    this->normalize();
+}
+
+void Generator::generate(std::string specification)
+{
+    std::vector<std::string> fields;
+    std::stringstream stream(specification);
+    std::string field;
+    while (std::getline(stream, field, ':'))
+        fields.push_back(field);
+
+    std::string name = fields.empty() ? "" : fields[0];
+
+    try
+    {
+        if (name == "gnp" && fields.size() == 3)
+            this->random(std::stoul(fields[1]), std::stod(fields[2]));
+        else if (name == "queen" && fields.size() == 2)
+            this->queen(std::stoul(fields[1]));
+        else if (name == "flat" && fields.size() == 4)
+            this->flat(std::stoul(fields[1]), std::stoul(fields[2]), std::stod(fields[3]));
+        else if (name == "leighton" && fields.size() == 4)
+            this->leighton(std::stoul(fields[1]), std::stoul(fields[2]), std::stoul(fields[3]));
+        else if (name == "chung-lu" && fields.size() == 4)
+            this->chungLu(std::stoul(fields[1]), std::stod(fields[2]), std::stod(fields[3]));
+        else
+            throw std::invalid_argument(name);
+    }
+    catch (std::logic_error &e)
+    {
+        throw std::runtime_error("Invalid graph specification '" + specification + "'!");
+    }
+}
+
+Graph *Generator::build()
+{
+    return new Graph(this->vertex_count, this->edges.data(), this->edges.size() / 2);
+}
+
+void Generator::writeDimacs(std::string filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("Could not write the graph file!");
+
+    file << "p edge " << this->vertex_count << " " << this->edges.size() / 2 << "\n";
+    for (unsigned long i = 0; i < this->edges.size(); i += 2)
+        file << "e " << this->edges[i] + 1 << " " << this->edges[i + 1] + 1 << "\n";
+}
+
+void Generator::writeBinary(std::string filename)
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Could not write the graph file!");
+
+    // Preamble length, then the preamble
+    std::string preamble = "p edge " + std::to_string(this->vertex_count) + " " + std::to_string(this->edges.size() / 2) + "\n";
+    file << preamble.size() << "\n"
+         << preamble;
+
+    // Lower neighbors of every vertex
+    std::vector<unsigned long> offsets((unsigned long)this->vertex_count + 1, 0);
+    for (unsigned long i = 0; i < this->edges.size(); i += 2)
+        offsets[this->edges[i + 1] + 1]++;
+    for (unsigned int v = 0; v < this->vertex_count; ++v)
+        offsets[v + 1] += offsets[v];
+
+    std::vector<unsigned int> lower(this->edges.size() / 2);
+    std::vector<unsigned long> next(offsets.begin(), offsets.end() - 1);
+    for (unsigned long i = 0; i < this->edges.size(); i += 2)
+        lower[next[this->edges[i + 1]]++] = this->edges[i];
+
+    // Row v has a bit for each vertex up to v, the highest bit of each byte first
+    std::vector<unsigned char> row;
+    for (unsigned int v = 0; v < this->vertex_count; ++v)
+    {
+        row.assign(v / 8 + 1, 0);
+        for (unsigned long i = offsets[v]; i < offsets[v + 1]; ++i)
+            row[lower[i] / 8] |= 0x80 >> (lower[i] % 8);
+
+        file.write((const char *)row.data(), row.size());
+    }
+}
+
+unsigned int Generator::getVertexCount()
+{
+    return this->vertex_count;
+}
+
+unsigned long Generator::getEdgeCount()
+{
+    return this->edges.size() / 2;
+}
@@ -1,123 +1,174 @@
 #include "Graph.h"
 
-Graph::Graph(std::string filename)
+template <typename Index>
+BasicGraph<Index>::BasicGraph(std::string filename, GraphFormat format)
 {
     this->used_colors_counter = 0;
 
-    // Try to open file
-    std::ifstream in_file(filename, std::ifstream::in);
+    // Parse the file into compressed rows
+    GraphReader reader(filename, format);
 
-    if (!in_file.is_open())
-        throw std::runtime_error("Input file does not exist!");
+    this->initializeRows(reader.getVertexCount(), reader.getOffsets(), reader.getTargets());
+}
+
+template <typename Index>
+BasicGraph<Index>::BasicGraph(unsigned int vertex_count, const unsigned int *edges, unsigned int edge_count)
+{
+    this->used_colors_counter = 0;
+
+    this->initialize(vertex_count, edge_count);
+
+    for (unsigned int i = 0; i < edge_count; ++i)
+        this->addEdge(edges[2 * i], edges[2 * i + 1]);
+}
+
+template <typename Index>
+BasicGraph<Index>::BasicGraph(unsigned int vertex_count, const unsigned int *offsets, const unsigned int *targets)
+{
+    this->used_colors_counter = 0;
+
+    this->initializeRows(vertex_count, offsets, targets);
+}
+
+template <typename Index>
+BasicGraph<Index>::BasicGraph(BasicGraph &graph)
+{
+    this->V = graph.V;
+    this->E = graph.E;
+    this->C = graph.C;
+
+    this->edge_count = graph.edge_count;
+    this->vertex_count = graph.vertex_count;
+    this->used_colors_counter = graph.used_colors_counter;
+}
 
-    std::string line;  // Line read from file
-    std::string token; // Token read from line
+template <typename Index>
+template <typename Other>
+BasicGraph<Index>::BasicGraph(BasicGraph<Other> &graph)
+{
+    this->used_colors_counter = 0;
 
-    int first, second; // Nodes that are part of an edge
+    this->initialize(graph.getVertexCount(), graph.getEdgeCount());
 
-    while (std::getline(in_file, line))
+    for (unsigned int u = 0; u < this->vertex_count; ++u)
     {
-        // Ignore blank lines
-        if (line.size() > 0)
-        {
-            // Stream input line
-            std::stringstream linestream(line);
+        const std::vector<Other> &adjacent = graph.getVertex(u)->getAdjacent();
+        for (auto v = adjacent.begin(); v != adjacent.end(); ++v)
+            this->V[u].setAdjacent(*v);
+    }
 
-            // Get line descriptor token
-            getline(linestream, token, ' ');
+    // Same colors, and the same order in every list of users
+    for (unsigned int c = 0; c < graph.getUsedColorCount(); ++c)
+        for (unsigned int i = graph.getColor(c)->getFirstUser(); i != (unsigned int)-1; i = graph.getVertex(i)->getNextUser())
+            this->colorVertex(i, c);
+}
 
-            // Check information type
-            switch (token.at(0))
-            {
-            case 'p': // Definition of graph
-            {
-                getline(linestream, token, ' '); // 'edge'
+template <typename Index>
+BasicGraph<Index>::~BasicGraph()
+{
+    // nil
+}
 
-                // Get vertex count
-                getline(linestream, token, ' ');
-                this->vertex_count = atoi(token.c_str());
+template <typename Index>
+void BasicGraph<Index>::initialize(unsigned int vertexes, unsigned int edges)
+{
+    if (!fitsIndex<Index>(vertexes))
+        throw std::runtime_error("Graph does not fit the index width!");
 
-                // Resize vertex set
-                V.resize(this->vertex_count);
-                C.resize(this->vertex_count);
+    this->vertex_count = vertexes;
+    this->edge_count = edges;
 
-                for (uint i = 0; i < this->vertex_count; V[i].setId(i), C[i].setId(i), ++i)
-                    ;
+    // Resize vertex set, colors are added as they are used
+    this->V.resize(this->vertex_count);
+    this->C.clear();
 
-                // Get edge count
-                getline(linestream, token, ' ');
-                this->edge_count = atoi(token.c_str());
-            }
-            break;
-            case 'e': // Edge
-            {
-                // Get first vertex
-                getline(linestream, token, ' ');
-                first = atoi(token.c_str());
+    for (uint i = 0; i < this->vertex_count; V[i].setId(i), ++i)
+        ;
+}
 
-                // Get second vertex
-                getline(linestream, token, ' ');
-                second = atoi(token.c_str());
+template <typename Index>
+void BasicGraph<Index>::initializeRows(unsigned int vertexes, const unsigned int *offsets, const unsigned int *targets)
+{
+    this->initialize(vertexes, 0);
 
-                // Update vertexes
-                this->V[first - 1].setAdjacent(second - 1);
-                this->V[second - 1].setAdjacent(first - 1);
-            }
-            break;
-            default: // Do nothing
-                break;
+    // Rows are filled to their exact size
+    for (unsigned int u = 0; u < vertexes; ++u)
+        this->V[u].reserveAdjacent(offsets[u + 1] - offsets[u]);
+
+    // Every edge appears in the rows of both of its vertexes, keep u < v only
+    for (unsigned int u = 0; u < vertexes; ++u)
+    {
+        for (unsigned int i = offsets[u]; i < offsets[u + 1]; ++i)
+        {
+            if (u == targets[i])
+                throw std::runtime_error("Edge is a loop!");
+
+            if (u < targets[i])
+            {
+                this->addEdge(u, targets[i]);
+                this->edge_count++;
             }
         }
     }
-
-    // Close file
-    in_file.close();
 }
 
-Graph::Graph(Graph &graph)
+template <typename Index>
+void BasicGraph<Index>::addEdge(unsigned int first, unsigned int second)
 {
-    this->V = graph.V;
-    this->E = graph.E;
-    this->C = graph.C;
+    if (first >= this->vertex_count || second >= this->vertex_count)
+        throw std::runtime_error("Edge endpoint out of range!");
 
-    this->edge_count = graph.edge_count;
-    this->vertex_count = graph.vertex_count;
-    this->used_colors_counter = graph.used_colors_counter;
+    // A vertex adjacent to itself cannot be colored
+    if (first == second)
+        throw std::runtime_error("Edge is a loop!");
+
+    this->V[first].setAdjacent(second);
+    this->V[second].setAdjacent(first);
 }
 
-Graph::~Graph()
+template <typename Index>
+bool BasicGraph<Index>::removeEdge(unsigned int first, unsigned int second)
 {
-    // nil
+    if (first >= this->vertex_count || second >= this->vertex_count)
+        throw std::runtime_error("Edge endpoint out of range!");
+
+    return this->V[first].removeAdjacent(second) && this->V[second].removeAdjacent(first);
 }
 
-uint Graph::getVertexCount()
+template <typename Index>
+uint BasicGraph<Index>::getVertexCount()
 {
     return this->vertex_count;
 }
 
-uint Graph::getEdgeCount()
+template <typename Index>
+uint BasicGraph<Index>::getEdgeCount()
 {
     return this->edge_count;
 }
 
-uint Graph::getUsedColorCount()
+template <typename Index>
+uint BasicGraph<Index>::getUsedColorCount()
 {
     return this->used_colors_counter;
 }
 
-std::vector<Vertex> Graph::getVertexes()
+template <typename Index>
+std::vector<BasicVertex<Index>> BasicGraph<Index>::getVertexes()
 {
     return this->V;
 }
 
-std::vector<Color> Graph::getColors()
+template <typename Index>
+std::vector<BasicColor<Index>> BasicGraph<Index>::getColors()
 {
     return this->C;
 }
 
-std::vector<Color> Graph::getUsedColors()
+template <typename Index>
+std::vector<BasicColor<Index>> BasicGraph<Index>::getUsedColors()
 {
-    std::vector<Color> new_vector;
+    std::vector<BasicColor<Index>> new_vector;
 
     for (auto i = this->C.begin(); i != this->C.end(); ++i)
     {
@@ -128,48 +179,121 @@ std::vector<Color> Graph::getUsedColors()
     return new_vector;
 }
 
-std::vector<Edge> Graph::getEdges()
+template <typename Index>
+std::vector<Edge> BasicGraph<Index>::getEdges()
 {
     return this->E;
 }
 
-Vertex *Graph::getVertex(unsigned int vertex_id)
+template <typename Index>
+BasicVertex<Index> *BasicGraph<Index>::getVertex(unsigned int vertex_id)
 {
     return &this->V[vertex_id];
 }
 
-Color *Graph::getColor(unsigned int color_id)
+template <typename Index>
+BasicColor<Index> *BasicGraph<Index>::getColor(unsigned int color_id)
 {
     return &this->C[color_id];
 }
 
-void Graph::colorVertex(unsigned int vertex_id, unsigned int color_id)
+template <typename Index>
+void BasicGraph<Index>::colorVertex(unsigned int vertex_id, unsigned int color_id)
 {
-    if (this->C[color_id].getUsageCounter() == 0)
+    // Open a new color, numbered right after the used ones
+    if (color_id > this->C.size())
+        throw std::runtime_error("Color is not used and is not the next one!");
+
+    if (color_id == this->C.size())
+    {
+        this->C.push_back(BasicColor<Index>(this->C.size()));
         this->used_colors_counter++;
+    }
 
     this->V[vertex_id].setColor(color_id);
 
+    // Append vertex to the color's list of users
+    unsigned int last = this->C[color_id].getLastUser();
+
+    if (last != (unsigned int)-1)
+        this->V[last].setNextUser(vertex_id);
+
+    this->V[vertex_id].setUserLinks(last, -1);
+
     this->C[color_id].addUser(vertex_id);
 }
 
-void Graph::cleanVertex(unsigned int vertex_id)
+template <typename Index>
+void BasicGraph<Index>::cleanVertex(unsigned int vertex_id)
 {
     unsigned int color_id = this->V[vertex_id].getColor();
+    unsigned int previous = this->V[vertex_id].getPreviousUser();
+    unsigned int next = this->V[vertex_id].getNextUser();
+
+    // Unlink vertex from the color's list of users
+    if (previous != (unsigned int)-1)
+        this->V[previous].setNextUser(next);
+
+    if (next != (unsigned int)-1)
+        this->V[next].setPreviousUser(previous);
 
-    this->C[color_id].removeUser(vertex_id);
+    this->C[color_id].removeUser(vertex_id, previous, next);
 
     this->V[vertex_id].setColor(-1);
+    this->V[vertex_id].setUserLinks(-1, -1);
 
     if (this->C[color_id].getUsageCounter() == 0)
+    {
+        // Renumber the highest color to the emptied one
+        unsigned int highest = this->C.size() - 1;
+        if (color_id != highest)
+        {
+            // Setting the color resets the links, keep them
+            for (unsigned int i = this->C[highest].getFirstUser(); i != (unsigned int)-1; i = this->V[i].getNextUser())
+            {
+                unsigned int previous_user = this->V[i].getPreviousUser();
+                unsigned int next_user = this->V[i].getNextUser();
+
+                this->V[i].setColor(color_id);
+                this->V[i].setUserLinks(previous_user, next_user);
+            }
+
+            this->C[color_id].takeUsers(this->C[highest]);
+        }
+
+        this->C.pop_back();
         this->used_colors_counter--;
+    }
+}
+
+template <typename Index>
+void BasicGraph<Index>::clearColoring()
+{
+    for (auto i = this->V.begin(); i != this->V.end(); ++i)
+    {
+        (*i).setColor(-1);
+        (*i).setUserLinks(-1, -1);
+    }
+
+    this->C.clear();
+    this->used_colors_counter = 0;
 }
 
-bool Graph::canUse(unsigned int vertex_id, unsigned int color_id)
+template <typename Index>
+void BasicGraph<Index>::getUsers(unsigned int color_id, std::vector<unsigned int> &users)
+{
+    users.clear();
+
+    for (unsigned int i = this->C[color_id].getFirstUser(); i != (unsigned int)-1; i = this->V[i].getNextUser())
+        users.push_back(i);
+}
+
+template <typename Index>
+bool BasicGraph<Index>::canUse(unsigned int vertex_id, unsigned int color_id)
 {
     bool can_use = true;
 
-    std::vector<unsigned int> adjacent = this->V[vertex_id].getAdjacent();
+    const std::vector<Index> &adjacent = this->V[vertex_id].getAdjacent();
 
     for (auto i = adjacent.begin(); can_use && i != adjacent.end(); ++i)
         if (this->V[*i].getColor() == color_id)
@@ -178,7 +302,148 @@ bool Graph::canUse(unsigned int vertex_id, unsigned int color_id)
     return can_use;
 }
 
-std::string Graph::outputInfo()
+template <typename Index>
+uint64_t BasicGraph<Index>::getCanonicalHash()
+{
+    // Every edge once, as (u, v) with u < v
+    std::vector<uint64_t> edges;
+    for (unsigned int u = 0; u < this->vertex_count; ++u)
+    {
+        const std::vector<Index> &adjacent = this->V[u].getAdjacent();
+        for (auto v = adjacent.begin(); v != adjacent.end(); ++v)
+            if (u < *v)
+                edges.push_back(((uint64_t)u << 32) | *v);
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    // FNV-1a over 64 bit words
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    hash = (hash ^ this->vertex_count) * 0x100000001B3ULL;
+    for (auto i = edges.begin(); i != edges.end(); ++i)
+        hash = (hash ^ *i) * 0x100000001B3ULL;
+
+    // Final avalanche
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+template <typename Index>
+unsigned int BasicGraph<Index>::getCliqueLowerBound()
+{
+    // Clique candidates, highest degree first
+    std::vector<unsigned int> order(this->vertex_count);
+    for (unsigned int i = 0; i < this->vertex_count; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+        return this->V[a].getAdjacent().size() > this->V[b].getAdjacent().size();
+    });
+
+    // Number of clique members each vertex is adjacent to, and the member
+    // that last counted it (adjacency lists may repeat vertexes)
+    std::vector<unsigned int> member_count(this->vertex_count);
+    std::vector<unsigned int> counted_by(this->vertex_count);
+    unsigned int stamp = 0;
+
+    unsigned int best = 0;
+    unsigned int starts = std::min(this->vertex_count, 64u);
+
+    for (unsigned int s = 0; s < starts; ++s)
+    {
+        std::fill(member_count.begin(), member_count.end(), 0);
+        unsigned int size = 0;
+
+        // Add every vertex adjacent to all current members, starting from order[s]
+        for (unsigned int i = 0; i < this->vertex_count; ++i)
+        {
+            unsigned int candidate = order[(s + i) % this->vertex_count];
+            if (member_count[candidate] != size)
+                continue;
+
+            ++stamp;
+            ++size;
+            const std::vector<Index> &adjacent = this->V[candidate].getAdjacent();
+            for (auto v = adjacent.begin(); v != adjacent.end(); ++v)
+            {
+                if (counted_by[*v] != stamp)
+                {
+                    counted_by[*v] = stamp;
+                    member_count[*v]++;
+                }
+            }
+        }
+
+        best = std::max(best, size);
+    }
+
+    return best;
+}
+
+template <typename Index>
+void BasicGraph<Index>::exportGlpk(std::string filename)
+{
+    // File for GLPK-ready output
+    std::ofstream data(filename);
+
+    // Write output file opening statement
+    data << "data;" << std::endl
+         << std::endl;
+
+    // Write big M
+    data << "# Big M parameter" << std::endl;
+    data << "param M := " << this->vertex_count << std::endl;
+
+    // Write vertex set
+    data << "# Vertex set (Numbered 0 through N-1)" << std::endl;
+    data << "set V :=";
+    for (unsigned int i = 0; i < this->vertex_count; i++)
+    {
+        data << " " << i;
+    }
+    data << ";" << std::endl
+         << std::endl;
+
+    // Write color set
+    data << "# Color set (Assuming worst case scenario where nColors = nVertexes)" << std::endl;
+    data << "set C :=";
+    for (unsigned int i = 0; i < this->vertex_count; i++)
+    {
+        data << " " << i;
+    }
+    data << ";" << std::endl
+         << std::endl;
+
+    // Write adjacency matrix
+    data << "# Graph adjacency matrix" << std::endl;
+    data << "param graph :=" << std::endl;
+    for (unsigned int i = 0; i < this->vertex_count; i++)
+    {
+        for (unsigned int j = 0; j < this->vertex_count; j++)
+        {
+            data << " [" << i << ", " << j << "] " << this->V[i].isAdjacentTo(j);
+            if (i < this->vertex_count - 1 || j < this->vertex_count - 1)
+            {
+                data << ",";
+            }
+        }
+        data << std::endl;
+    }
+    data << ";" << std::endl
+         << std::endl;
+
+    // Write output file closing statement
+    data << "end;" << std::endl;
+
+    // Close file
+    data.close();
+}
+
+template <typename Index>
+std::string BasicGraph<Index>::outputInfo()
 {
     std::stringstream info;
 
@@ -187,3 +452,9 @@ std::string Graph::outputInfo()
 
     return info.str();
 }
+
+// Both index widths, and the conversions between them, see Index.h
+template class BasicGraph<uint16_t>;
+template class BasicGraph<uint32_t>;
+template BasicGraph<uint16_t>::BasicGraph(BasicGraph<uint32_t> &graph);
+template BasicGraph<uint32_t>::BasicGraph(BasicGraph<uint16_t> &graph);
@@ -0,0 +1,561 @@
+#include "GraphReader.h"
+
+GraphReader::GraphReader(std::string filename, GraphFormat file_format)
+{
+    this->input = new InputStream(filename);
+    this->chunk = NULL;
+    this->position = 0;
+    this->length = 0;
+    this->line = 1;
+    this->vertex_count = 0;
+
+    try
+    {
+        this->format = file_format == FORMAT_AUTO ? this->detect(filename) : file_format;
+
+        switch (this->format)
+        {
+        case FORMAT_DIMACS_BINARY:
+            this->readDimacsBinary();
+            break;
+        case FORMAT_EDGE_LIST:
+            this->readEdgeList();
+            break;
+        case FORMAT_METIS:
+            this->readMetis();
+            break;
+        case FORMAT_MATRIX_MARKET:
+            this->readMatrixMarket();
+            break;
+        default:
+            this->readDimacs();
+            break;
+        }
+    }
+    catch (...)
+    {
+        delete this->input;
+        throw;
+    }
+
+    delete this->input;
+
+    this->buildRows();
+}
+
+GraphReader::~GraphReader()
+{
+    // nil
+}
+
+bool GraphReader::refill()
+{
+    this->position = 0;
+    if (!this->input->next(this->chunk, this->length))
+        this->length = 0;
+
+    return this->length > 0;
+}
+
+void GraphReader::skipSpaces()
+{
+    int c = this->peek();
+    while (c == ' ' || c == '\t' || c == '\r')
+    {
+        this->skip();
+        c = this->peek();
+    }
+}
+
+void GraphReader::skipLine()
+{
+    while (true)
+    {
+        // Look for the line end in the buffered part
+        if (this->position == this->length && !this->refill())
+            return;
+
+        const char *start = this->chunk + this->position;
+        const char *end = (const char *)memchr(start, '\n', this->length - this->position);
+
+        if (end != NULL)
+        {
+            this->position += end - start + 1;
+            this->line++;
+            return;
+        }
+
+        this->position = this->length;
+    }
+}
+
+bool GraphReader::readNumber(unsigned long &value)
+{
+    this->skipSpaces();
+
+    int c = this->peek();
+    if (c == '\n' || c == EOF)
+        return false;
+    if (c < '0' || c > '9')
+        this->fail("Invalid number");
+
+    value = 0;
+    while (c >= '0' && c <= '9')
+    {
+        value = value * 10 + (c - '0');
+        if (value > 0xFFFFFFFFul)
+            this->fail("Number out of range");
+
+        this->skip();
+        c = this->peek();
+    }
+
+    if (c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != EOF)
+        this->fail("Invalid number");
+
+    return true;
+}
+
+std::string GraphReader::readWord()
+{
+    this->skipSpaces();
+
+    std::string word;
+    int c = this->peek();
+    while (c != ' ' && c != '\t' && c != '\r' && c != '\n' && c != EOF)
+    {
+        word.push_back(c);
+        this->skip();
+        c = this->peek();
+    }
+
+    return word;
+}
+
+void GraphReader::fail(std::string message)
+{
+    throw std::runtime_error(message + " on line " + std::to_string(this->line) + "!");
+}
+
+void GraphReader::addEdge(unsigned long first, unsigned long second)
+{
+    this->edges.push_back(first);
+    this->edges.push_back(second);
+}
+
+GraphFormat GraphReader::detect(std::string filename)
+{
+    // Signatures at the start of the file
+    this->peek();
+    std::string start(this->chunk != NULL ? this->chunk : "", std::min(this->length, 256ul));
+
+    if (start.compare(0, 14, "%%MatrixMarket") == 0)
+        return FORMAT_MATRIX_MARKET;
+
+    // Binary DIMACS starts with the length of its preamble, then the preamble
+    size_t digits = start.find_first_not_of("0123456789");
+    if (digits > 0 && digits != std::string::npos && start[digits] == '\n' && digits + 1 < start.size() &&
+        (start[digits + 1] == 'c' || start[digits + 1] == 'p'))
+        return FORMAT_DIMACS_BINARY;
+
+    if (!start.empty() && (start[0] == 'c' || start[0] == 'p' || start[0] == 'e'))
+        return FORMAT_DIMACS;
+
+    // Formats without a signature
+    filename = InputStream::stripCompression(filename);
+    size_t dot = filename.rfind('.');
+    std::string extension = dot == std::string::npos ? "" : filename.substr(dot);
+
+    if (extension == ".graph" || extension == ".metis")
+        return FORMAT_METIS;
+    if (extension == ".mtx")
+        return FORMAT_MATRIX_MARKET;
+    if (extension == ".b")
+        return FORMAT_DIMACS_BINARY;
+    if (extension == ".col")
+        return FORMAT_DIMACS;
+
+    return FORMAT_EDGE_LIST;
+}
+
+void GraphReader::readDimacs()
+{
+    bool header = false;
+    unsigned long first, second;
+
+    while (this->peek() != EOF)
+    {
+        this->skipSpaces();
+
+        switch (this->peek())
+        {
+        case 'p': // Definition of graph, "p edge n m"
+        {
+            this->skip();
+            this->readWord();
+
+            unsigned long edge_count;
+            if (!this->readNumber(first) || !this->readNumber(edge_count))
+                this->fail("Invalid problem line");
+            if (first >= 0xFFFFFFFFul)
+                this->fail("Too many vertexes");
+
+            this->vertex_count = first;
+            this->edges.reserve(2 * edge_count);
+            header = true;
+        }
+        break;
+        case 'e': // Edge
+        {
+            this->skip();
+
+            if (!header)
+                this->fail("Edge before the problem line");
+            if (!this->readNumber(first) || !this->readNumber(second))
+                this->fail("Invalid edge");
+            if (first == 0 || second == 0 || first > this->vertex_count || second > this->vertex_count)
+                this->fail("Edge endpoint out of range");
+
+            this->addEdge(first - 1, second - 1);
+        }
+        break;
+        case 'c':  // Comment
+        case 'n':  // Vertex descriptor
+        case '\n': // Blank line
+        case EOF:
+            break;
+        default:
+            this->fail("Unknown DIMACS line");
+        }
+
+        this->skipLine();
+    }
+
+    if (!header)
+        throw std::runtime_error("Missing DIMACS problem line!");
+}
+
+void GraphReader::readDimacsBinary()
+{
+    unsigned long preamble_length, edge_count = 0;
+    if (!this->readNumber(preamble_length))
+        this->fail("Invalid preamble length");
+    this->skipLine();
+
+    // Text preamble, with the problem line
+    std::string preamble;
+    while (preamble.size() < preamble_length && this->peek() != EOF)
+    {
+        preamble.push_back(this->peek());
+        this->skip();
+    }
+
+    std::istringstream lines(preamble);
+    std::string text;
+    bool header = false;
+    while (!header && std::getline(lines, text))
+    {
+        std::istringstream fields(text);
+        std::string token, name;
+        if (text.size() > 0 && text[0] == 'p')
+            header = (bool)(fields >> token >> name >> this->vertex_count >> edge_count);
+    }
+
+    if (!header)
+        throw std::runtime_error("Missing DIMACS problem line!");
+    if (this->vertex_count == 0xFFFFFFFFu)
+        throw std::runtime_error("Graph has too many vertexes!");
+
+    this->edges.reserve(2 * edge_count);
+
+    // Row i has a bit for each vertex j <= i, the highest bit of each byte
+    // first; rows of dense graphs are decoded one set bit at a time, and
+    // sparse ones skip empty words
+    for (unsigned long i = 0; i < this->vertex_count; ++i)
+    {
+        unsigned long row_bytes = i / 8 + 1;
+        unsigned long done = 0;
+
+        while (done < row_bytes)
+        {
+            if (this->position == this->length && !this->refill())
+                throw std::runtime_error("Truncated DIMACS binary file!");
+
+            unsigned long span = std::min(this->length - this->position, row_bytes - done);
+            const unsigned char *data = (const unsigned char *)this->chunk + this->position;
+
+            for (unsigned long k = 0; k < span;)
+            {
+                uint64_t word;
+                if (k + 8 <= span && (memcpy(&word, data + k, 8), word == 0))
+                {
+                    k += 8;
+                    continue;
+                }
+
+                unsigned int bits = data[k];
+                while (bits != 0)
+                {
+                    unsigned int high = 31 - __builtin_clz(bits);
+                    unsigned long j = (done + k) * 8 + (7 - high);
+                    if (j < i)
+                        this->addEdge(j, i);
+
+                    bits &= ~(1u << high);
+                }
+
+                k++;
+            }
+
+            this->position += span;
+            done += span;
+        }
+    }
+}
+
+void GraphReader::readEdgeList()
+{
+    unsigned long first, second, highest = 0;
+    bool any = false;
+
+    while (this->peek() != EOF)
+    {
+        this->skipSpaces();
+
+        int c = this->peek();
+        if (c != '#' && c != '%' && c != '\n' && c != EOF)
+        {
+            if (!this->readNumber(first) || !this->readNumber(second))
+                this->fail("Invalid edge");
+
+            this->addEdge(first, second);
+            highest = std::max(highest, std::max(first, second));
+            any = true;
+        }
+
+        this->skipLine();
+    }
+
+    if (highest >= 0xFFFFFFFFul)
+        throw std::runtime_error("Graph has too many vertexes!");
+
+    this->vertex_count = any ? highest + 1 : 0;
+}
+
+void GraphReader::readMetis()
+{
+    // Comments before the header
+    this->skipSpaces();
+    while (this->peek() == '%' || this->peek() == '\n')
+    {
+        this->skipLine();
+        this->skipSpaces();
+    }
+
+    // "n m [fmt [ncon]]": fmt digits flag vertex sizes, vertex weights and edge weights
+    unsigned long vertexes, edge_count, flags = 0, constraints = 1;
+    if (!this->readNumber(vertexes) || !this->readNumber(edge_count))
+        this->fail("Invalid METIS header");
+    if (vertexes >= 0xFFFFFFFFul)
+        this->fail("Too many vertexes");
+    if (this->readNumber(flags))
+        this->readNumber(constraints);
+    this->skipLine();
+
+    bool sizes = flags / 100 % 10, vertex_weights = flags / 10 % 10, edge_weights = flags % 10;
+    unsigned long value, neighbor;
+
+    this->vertex_count = vertexes;
+    this->edges.reserve(4 * edge_count);
+
+    // One line per vertex, blank for vertexes without neighbors
+    for (unsigned long v = 0; v < vertexes;)
+    {
+        this->skipSpaces();
+
+        int c = this->peek();
+        if (c == EOF)
+            this->fail("Missing METIS vertex line");
+        if (c == '%')
+        {
+            this->skipLine();
+            continue;
+        }
+
+        if (sizes && !this->readNumber(value))
+            this->fail("Missing vertex size");
+        for (unsigned long i = 0; vertex_weights && i < constraints; ++i)
+            if (!this->readNumber(value))
+                this->fail("Missing vertex weight");
+
+        while (this->readNumber(neighbor))
+        {
+            if (neighbor == 0 || neighbor > vertexes)
+                this->fail("Edge endpoint out of range");
+            if (edge_weights && !this->readNumber(value))
+                this->fail("Missing edge weight");
+
+            this->addEdge(v, neighbor - 1);
+        }
+
+        this->skipLine();
+        v++;
+    }
+}
+
+void GraphReader::readMatrixMarket()
+{
+    // "%%MatrixMarket matrix coordinate <field> <symmetry>"
+    this->readWord();
+    std::string object = this->readWord(), layout = this->readWord();
+    if (object != "matrix" || layout != "coordinate")
+        this->fail("Only coordinate MatrixMarket matrices are supported");
+    this->skipLine();
+
+    // Comments, then "rows columns entries"
+    this->skipSpaces();
+    while (this->peek() == '%' || this->peek() == '\n')
+    {
+        this->skipLine();
+        this->skipSpaces();
+    }
+
+    unsigned long rows, columns, entries, row, column;
+    if (!this->readNumber(rows) || !this->readNumber(columns) || !this->readNumber(entries))
+        this->fail("Invalid MatrixMarket size line");
+    if (rows != columns)
+        this->fail("MatrixMarket matrix is not square");
+    if (rows >= 0xFFFFFFFFul)
+        this->fail("Too many vertexes");
+    this->skipLine();
+
+    this->vertex_count = rows;
+    this->edges.reserve(2 * entries);
+
+    // Entries, values are ignored
+    for (unsigned long e = 0; e < entries;)
+    {
+        this->skipSpaces();
+
+        int c = this->peek();
+        if (c == EOF)
+            this->fail("Missing MatrixMarket entry");
+        if (c == '%' || c == '\n')
+        {
+            this->skipLine();
+            continue;
+        }
+
+        if (!this->readNumber(row) || !this->readNumber(column))
+            this->fail("Invalid MatrixMarket entry");
+        if (row == 0 || column == 0 || row > rows || column > rows)
+            this->fail("Entry out of range");
+
+        this->addEdge(row - 1, column - 1);
+        this->skipLine();
+        e++;
+    }
+}
+
+void GraphReader::buildRows()
+{
+    if (this->edges.size() > 0xFFFFFFFFul)
+        throw std::runtime_error("Graph has too many edges!");
+
+    // Both directions of every edge but loops
+    this->offsets.assign((unsigned long)this->vertex_count + 1, 0);
+    for (unsigned long i = 0; i < this->edges.size(); i += 2)
+    {
+        if (this->edges[i] != this->edges[i + 1])
+        {
+            this->offsets[this->edges[i] + 1]++;
+            this->offsets[this->edges[i + 1] + 1]++;
+        }
+    }
+
+    for (unsigned int v = 0; v < this->vertex_count; ++v)
+        this->offsets[v + 1] += this->offsets[v];
+
+    this->targets.resize(this->offsets[this->vertex_count]);
+    std::vector<unsigned int> next(this->offsets.begin(), this->offsets.end() - 1);
+    for (unsigned long i = 0; i < this->edges.size(); i += 2)
+    {
+        unsigned int first = this->edges[i], second = this->edges[i + 1];
+        if (first != second)
+        {
+            this->targets[next[first]++] = second;
+            this->targets[next[second]++] = first;
+        }
+    }
+
+    std::vector<unsigned int>().swap(this->edges);
+    std::vector<unsigned int>().swap(next);
+
+    // Sort every row and drop repeated edges, packing the rows
+    unsigned int packed = 0;
+    for (unsigned int v = 0; v < this->vertex_count; ++v)
+    {
+        unsigned int begin = this->offsets[v], end = this->offsets[v + 1];
+        std::sort(this->targets.begin() + begin, this->targets.begin() + end);
+
+        this->offsets[v] = packed;
+        for (unsigned int i = begin; i < end; ++i)
+            if (i == begin || this->targets[i] != this->targets[i - 1])
+                this->targets[packed++] = this->targets[i];
+    }
+
+    this->offsets[this->vertex_count] = packed;
+    this->targets.resize(packed);
+    this->targets.shrink_to_fit();
+}
+
+GraphFormat GraphReader::parse(std::string name)
+{
+    if (name == "auto")
+        return FORMAT_AUTO;
+    if (name == "dimacs")
+        return FORMAT_DIMACS;
+    if (name == "dimacs-binary")
+        return FORMAT_DIMACS_BINARY;
+    if (name == "edges")
+        return FORMAT_EDGE_LIST;
+    if (name == "metis")
+        return FORMAT_METIS;
+    if (name == "mtx")
+        return FORMAT_MATRIX_MARKET;
+
+    throw std::runtime_error("Unknown graph format '" + name + "'!");
+}
+
+bool GraphReader::isGraphFile(std::string filename)
+{
+    filename = InputStream::stripCompression(filename);
+    size_t dot = filename.rfind('.');
+    if (dot == std::string::npos)
+        return false;
+
+    std::string extension = filename.substr(dot);
+
+    return extension == ".col" || extension == ".b" || extension == ".edges" || extension == ".el" ||
+           extension == ".graph" || extension == ".metis" || extension == ".mtx";
+}
+
+GraphFormat GraphReader::getFormat()
+{
+    return this->format;
+}
+
+unsigned int GraphReader::getVertexCount()
+{
+    return this->vertex_count;
+}
+
+const unsigned int *GraphReader::getOffsets()
+{
+    return this->offsets.data();
+}
+
+const unsigned int *GraphReader::getTargets()
+{
+    return this->targets.data();
+}
@@ -0,0 +1,411 @@
+#include "InputStream.h"
+
+InputStream::InputStream(std::string filename)
+{
+    if (filename == "-")
+        this->file = stdin;
+    else
+        this->file = fopen(filename.c_str(), "rb");
+
+    if (this->file == NULL)
+        throw std::runtime_error("Input file does not exist!");
+
+    // Magic bytes of the compressed formats
+    this->head.resize(CHUNK_SIZE);
+    this->head_length = fread(this->head.data(), 1, CHUNK_SIZE, this->file);
+    this->head_taken = false;
+
+    const unsigned char *magic = (const unsigned char *)this->head.data();
+    if (this->head_length >= 2 && magic[0] == 0x1F && magic[1] == 0x8B)
+        this->compression = COMPRESSION_GZIP;
+    else if (this->head_length >= 6 && memcmp(magic, "\xFD" "7zXZ\x00", 6) == 0)
+        this->compression = COMPRESSION_XZ;
+    else if (this->head_length >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD)
+        this->compression = COMPRESSION_ZSTD;
+    else
+        this->compression = COMPRESSION_NONE;
+
+    this->current = -1;
+    this->finished = false;
+    this->stopping = false;
+
+    if (this->compression == COMPRESSION_NONE)
+        return;
+
+    std::string missing;
+#ifndef WITH_ZLIB
+    if (this->compression == COMPRESSION_GZIP)
+        missing = "gzip support, rebuild with 'make ZLIB=1'";
+#endif
+#ifndef WITH_LZMA
+    if (this->compression == COMPRESSION_XZ)
+        missing = "xz support, rebuild with 'make LZMA=1'";
+#endif
+#ifndef WITH_ZSTD
+    if (this->compression == COMPRESSION_ZSTD)
+        missing = "zstd support, rebuild with 'make ZSTD=1'";
+#endif
+
+    if (!missing.empty())
+    {
+        if (this->file != stdin)
+            fclose(this->file);
+        throw std::runtime_error("Built without " + missing + "!");
+    }
+
+    this->buffers.assign(BUFFER_COUNT, std::vector<char>(CHUNK_SIZE));
+    for (unsigned int i = 0; i < BUFFER_COUNT; ++i)
+        this->free_buffers.push_back(i);
+
+    this->worker = std::thread(&InputStream::decompress, this);
+}
+
+InputStream::~InputStream()
+{
+    if (this->worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->stopping = true;
+        }
+        this->changed.notify_all();
+
+        this->worker.join();
+    }
+
+    if (this->file != stdin)
+        fclose(this->file);
+}
+
+unsigned long InputStream::readRaw(char *data, unsigned long size)
+{
+    if (!this->head_taken)
+    {
+        this->head_taken = true;
+        if (data != this->head.data())
+            memcpy(data, this->head.data(), this->head_length);
+        return this->head_length;
+    }
+
+    unsigned long count = fread(data, 1, size, this->file);
+    if (count == 0 && ferror(this->file))
+        throw std::runtime_error("Could not read the input!");
+
+    return count;
+}
+
+int InputStream::acquire()
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->changed.wait(guard, [this]() { return !this->free_buffers.empty() || this->stopping; });
+
+    if (this->stopping)
+        return -1;
+
+    unsigned int index = this->free_buffers.front();
+    this->free_buffers.pop_front();
+
+    return index;
+}
+
+void InputStream::publish(unsigned int index, unsigned long size)
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        if (size > 0)
+            this->ready.push_back(std::make_pair(index, size));
+        else
+            this->free_buffers.push_back(index);
+    }
+
+    this->changed.notify_all();
+}
+
+void InputStream::decompress()
+{
+    std::string message;
+
+    try
+    {
+        if (this->compression == COMPRESSION_GZIP)
+            this->inflateGzip();
+        else if (this->compression == COMPRESSION_XZ)
+            this->decodeXz();
+        else
+            this->decodeZstd();
+    }
+    catch (std::exception &e)
+    {
+        message = e.what();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->error = message;
+        this->finished = true;
+    }
+
+    this->changed.notify_all();
+}
+
+void InputStream::inflateGzip()
+{
+#ifdef WITH_ZLIB
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+
+    // Gzip or zlib header
+    if (inflateInit2(&z, 15 + 32) != Z_OK)
+        throw std::runtime_error("Could not start the gzip decompression!");
+
+    std::vector<char> input(CHUNK_SIZE);
+    int index = this->acquire();
+
+    try
+    {
+        bool input_done = false, member_done = false;
+
+        if (index >= 0)
+        {
+            z.next_out = (Bytef *)this->buffers[index].data();
+            z.avail_out = CHUNK_SIZE;
+        }
+
+        while (index >= 0)
+        {
+            if (z.avail_in == 0 && !input_done)
+            {
+                unsigned long count = this->readRaw(input.data(), CHUNK_SIZE);
+                input_done = count == 0;
+                z.next_in = (Bytef *)input.data();
+                z.avail_in = count;
+            }
+
+            if (input_done && z.avail_in == 0 && member_done)
+                break;
+
+            int status = inflate(&z, Z_NO_FLUSH);
+
+            // Concatenated members are decompressed one after the other
+            if (status == Z_STREAM_END)
+            {
+                member_done = true;
+                inflateReset(&z);
+            }
+            else if (status == Z_OK)
+                member_done = false;
+            else if (status == Z_BUF_ERROR && input_done)
+                throw std::runtime_error("Truncated gzip input!");
+            else if (status != Z_BUF_ERROR)
+                throw std::runtime_error("Corrupt gzip input!");
+
+            if (z.avail_out == 0)
+            {
+                this->publish(index, CHUNK_SIZE);
+                index = this->acquire();
+                if (index >= 0)
+                {
+                    z.next_out = (Bytef *)this->buffers[index].data();
+                    z.avail_out = CHUNK_SIZE;
+                }
+            }
+        }
+
+        if (index >= 0)
+            this->publish(index, CHUNK_SIZE - z.avail_out);
+    }
+    catch (...)
+    {
+        inflateEnd(&z);
+        throw;
+    }
+
+    inflateEnd(&z);
+#endif
+}
+
+void InputStream::decodeXz()
+{
+#ifdef WITH_LZMA
+    lzma_stream s = LZMA_STREAM_INIT;
+
+    if (lzma_stream_decoder(&s, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+        throw std::runtime_error("Could not start the xz decompression!");
+
+    std::vector<char> input(CHUNK_SIZE);
+    int index = this->acquire();
+
+    try
+    {
+        lzma_action action = LZMA_RUN;
+
+        if (index >= 0)
+        {
+            s.next_out = (uint8_t *)this->buffers[index].data();
+            s.avail_out = CHUNK_SIZE;
+        }
+
+        while (index >= 0)
+        {
+            if (s.avail_in == 0 && action == LZMA_RUN)
+            {
+                unsigned long count = this->readRaw(input.data(), CHUNK_SIZE);
+                if (count == 0)
+                    action = LZMA_FINISH;
+                s.next_in = (const uint8_t *)input.data();
+                s.avail_in = count;
+            }
+
+            lzma_ret status = lzma_code(&s, action);
+
+            if (status == LZMA_BUF_ERROR)
+                throw std::runtime_error("Truncated xz input!");
+            if (status != LZMA_OK && status != LZMA_STREAM_END)
+                throw std::runtime_error("Corrupt xz input!");
+
+            if (s.avail_out == 0 || status == LZMA_STREAM_END)
+            {
+                this->publish(index, CHUNK_SIZE - s.avail_out);
+                if (status == LZMA_STREAM_END)
+                    break;
+
+                index = this->acquire();
+                if (index >= 0)
+                {
+                    s.next_out = (uint8_t *)this->buffers[index].data();
+                    s.avail_out = CHUNK_SIZE;
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        lzma_end(&s);
+        throw;
+    }
+
+    lzma_end(&s);
+#endif
+}
+
+void InputStream::decodeZstd()
+{
+#ifdef WITH_ZSTD
+    ZSTD_DStream *stream = ZSTD_createDStream();
+    if (stream == NULL || ZSTD_isError(ZSTD_initDStream(stream)))
+        throw std::runtime_error("Could not start the zstd decompression!");
+
+    std::vector<char> input(CHUNK_SIZE);
+    int index = this->acquire();
+
+    try
+    {
+        bool input_done = false, output_full = false;
+        size_t pending = 0;
+        ZSTD_inBuffer in = {input.data(), 0, 0};
+        ZSTD_outBuffer out = {index >= 0 ? this->buffers[index].data() : NULL, CHUNK_SIZE, 0};
+
+        while (index >= 0)
+        {
+            if (in.pos == in.size && !input_done)
+            {
+                in.size = this->readRaw(input.data(), CHUNK_SIZE);
+                in.pos = 0;
+                input_done = in.size == 0;
+            }
+
+            // Once the input is consumed and the last call had room left,
+            // everything was written and the last frame must be complete
+            if (input_done && in.pos == in.size && !output_full)
+            {
+                if (pending != 0)
+                    throw std::runtime_error("Truncated zstd input!");
+
+                this->publish(index, out.pos);
+                break;
+            }
+
+            pending = ZSTD_decompressStream(stream, &out, &in);
+            if (ZSTD_isError(pending))
+                throw std::runtime_error("Corrupt zstd input!");
+
+            output_full = out.pos == out.size;
+            if (output_full)
+            {
+                this->publish(index, out.pos);
+                index = this->acquire();
+                if (index >= 0)
+                {
+                    out.dst = this->buffers[index].data();
+                    out.pos = 0;
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        ZSTD_freeDStream(stream);
+        throw;
+    }
+
+    ZSTD_freeDStream(stream);
+#endif
+}
+
+bool InputStream::next(const char *&data, unsigned long &size)
+{
+    // Plain input, read straight into the head buffer
+    if (this->compression == COMPRESSION_NONE)
+    {
+        size = this->readRaw(this->head.data(), CHUNK_SIZE);
+        data = this->head.data();
+
+        return size > 0;
+    }
+
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    // The previous chunk can be filled again
+    if (this->current >= 0)
+    {
+        this->free_buffers.push_back(this->current);
+        this->current = -1;
+        this->changed.notify_all();
+    }
+
+    this->changed.wait(guard, [this]() { return !this->ready.empty() || this->finished; });
+
+    if (this->ready.empty())
+    {
+        if (!this->error.empty())
+            throw std::runtime_error(this->error);
+
+        return false;
+    }
+
+    this->current = this->ready.front().first;
+    size = this->ready.front().second;
+    data = this->buffers[this->current].data();
+    this->ready.pop_front();
+
+    return true;
+}
+
+std::string InputStream::stripCompression(std::string filename)
+{
+    const char *extensions[] = {".gz", ".xz", ".zst"};
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        std::string extension = extensions[i];
+        if (filename.size() > extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0)
+            return filename.substr(0, filename.size() - extension.size());
+    }
+
+    return filename;
+}
+
+Compression InputStream::getCompression()
+{
+    return this->compression;
+}
@@ -0,0 +1,154 @@
+#include "Instrumentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+
+std::atomic<unsigned long long> Instrumentation::ticks[PHASE_COUNT];
+std::atomic<unsigned long long> Instrumentation::calls[PHASE_COUNT];
+std::atomic<unsigned long long> Instrumentation::counters[COUNTER_COUNT];
+std::atomic<unsigned long long> Instrumentation::band_accepted[BAND_COUNT];
+std::atomic<unsigned long long> Instrumentation::band_evaluated[BAND_COUNT];
+unsigned long long Instrumentation::steady_state_begin = 0;
+unsigned long long Instrumentation::steady_state_end = 0;
+unsigned long long Instrumentation::start_ticks = Instrumentation::now();
+std::chrono::steady_clock::time_point Instrumentation::start_time = std::chrono::steady_clock::now();
+std::atomic<unsigned long long> Instrumentation::heap_allocations(0);
+
+// Names used in the JSON output
+static const char *phase_names[PHASE_COUNT] = {
+    "neighbor_generation",
+    "local_search",
+    "acceptance",
+    "logging",
+    "deletion"};
+
+static const char *counter_names[COUNTER_COUNT] = {
+    "randomize_moves",
+    "local_search_moves",
+    "accepted",
+    "rejected",
+    "uphill",
+    "best_improvements",
+    "state_allocations"};
+
+// Output file registered by dumpAtExit
+static std::string exit_filename;
+
+void Instrumentation::recordBand(double temperature, unsigned long long accepted, unsigned long long evaluated)
+{
+    int band = (int)std::floor(std::log10(temperature)) + BAND_OFFSET;
+
+    // Clamp to the available bands
+    band = std::max(0, std::min(BAND_COUNT - 1, band));
+
+    band_accepted[band].fetch_add(accepted, std::memory_order_relaxed);
+    band_evaluated[band].fetch_add(evaluated, std::memory_order_relaxed);
+}
+
+void Instrumentation::steadyStateBegin()
+{
+    steady_state_begin = heap_allocations.load();
+    steady_state_end = steady_state_begin;
+}
+
+void Instrumentation::steadyStateEnd()
+{
+    steady_state_end = heap_allocations.load();
+}
+
+unsigned long long Instrumentation::get(Counter counter)
+{
+    return counters[counter];
+}
+
+void Instrumentation::writeJson(std::string filename)
+{
+    // Calibrate ticks against wall clock time
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    unsigned long long elapsed_ticks = now() - start_ticks;
+    double seconds_per_tick = elapsed_ticks > 0 ? elapsed / elapsed_ticks : 0;
+
+    std::ofstream out(filename);
+
+    out << "{" << std::endl
+        << "  \"elapsed_seconds\": " << elapsed << "," << std::endl;
+
+    // Phases
+    out << "  \"phases\": {" << std::endl;
+    for (unsigned int i = 0; i < PHASE_COUNT; ++i)
+    {
+        out << "    \"" << phase_names[i] << "\": {\"calls\": " << calls[i]
+            << ", \"ticks\": " << ticks[i]
+            << ", \"seconds\": " << ticks[i] * seconds_per_tick << "}"
+            << (i < PHASE_COUNT - 1 ? "," : "") << std::endl;
+    }
+    out << "  }," << std::endl;
+
+    // Counters
+    out << "  \"counters\": {" << std::endl;
+    for (unsigned int i = 0; i < COUNTER_COUNT; ++i)
+        out << "    \"" << counter_names[i] << "\": " << counters[i] << "," << std::endl;
+    out << "    \"heap_allocations\": " << heap_allocations.load() << "," << std::endl;
+    out << "    \"steady_state_heap_allocations\": "
+        << steady_state_end - steady_state_begin << std::endl;
+    out << "  }," << std::endl;
+
+    // Acceptance rate per temperature band
+    out << "  \"temperature_bands\": [" << std::endl;
+    bool first = true;
+    for (int i = 0; i < BAND_COUNT; ++i)
+    {
+        if (band_evaluated[i] == 0)
+            continue;
+
+        out << (first ? "" : ",\n")
+            << "    {\"log10_temperature\": " << i - BAND_OFFSET
+            << ", \"accepted\": " << band_accepted[i]
+            << ", \"evaluated\": " << band_evaluated[i]
+            << ", \"acceptance_rate\": " << (double)band_accepted[i] / band_evaluated[i] << "}";
+        first = false;
+    }
+    out << std::endl;
+    out << "  ]" << std::endl
+        << "}" << std::endl;
+
+    out.close();
+}
+
+void Instrumentation::dumpAtExit(std::string filename)
+{
+    exit_filename = filename;
+
+    std::atexit([]() { Instrumentation::writeJson(exit_filename); });
+}
+
+#ifdef INSTRUMENTATION
+
+// Count every heap allocation performed by the process
+
+void *operator new(std::size_t size)
+{
+    Instrumentation::heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    void *ptr = std::malloc(size > 0 ? size : 1);
+
+    if (ptr == NULL)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include "Options.h"
+
+#include <cstdlib>
+
+Options::Options(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument(argv[i]);
+
+        if (argument.size() > 2 && argument.compare(0, 2, "--") == 0)
+        {
+            // Option, with an optional value after '='
+            size_t equals = argument.find('=');
+
+            if (equals == std::string::npos)
+                this->options[argument.substr(2)] = "";
+            else
+                this->options[argument.substr(2, equals - 2)] = argument.substr(equals + 1);
+        }
+        else
+        {
+            this->arguments.push_back(argument);
+        }
+    }
+}
+
+Options::~Options()
+{
+    // nil
+}
+
+bool Options::has(std::string name)
+{
+    return this->options.count(name) > 0;
+}
+
+std::string Options::get(std::string name, std::string fallback)
+{
+    auto option = this->options.find(name);
+
+    return option != this->options.end() ? option->second : fallback;
+}
+
+double Options::getNumber(std::string name, double fallback)
+{
+    auto option = this->options.find(name);
+
+    if (option == this->options.end() || option->second.empty())
+        return fallback;
+
+    // The whole value must be a number, "--threads=abc" is not 0
+    char *end;
+    double value = strtod(option->second.c_str(), &end);
+    if (*end != '\0')
+        throw std::runtime_error("Option --" + name + " needs a number, not '" + option->second + "'!");
+
+    return value;
+}
+
+std::string Options::findUnknown(const std::vector<std::string> &known)
+{
+    for (auto option = this->options.begin(); option != this->options.end(); ++option)
+        if (std::find(known.begin(), known.end(), option->first) == known.end())
+            return option->first;
+
+    return "";
+}
+
+const std::vector<std::string> &Options::getArguments()
+{
+    return this->arguments;
+}
@@ -0,0 +1,43 @@
+#include "Random.h"
+
+// SplitMix64 step, used to expand seeds into generator states
+static uint64_t splitmix64(uint64_t &x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+Random::Random(uint64_t seed, uint64_t stream)
+{
+    this->seed(seed, stream);
+}
+
+Random::~Random()
+{
+    // nil
+}
+
+void Random::seed(uint64_t seed, uint64_t stream)
+{
+    // Mix stream into the seed so that every stream starts far apart
+    uint64_t x = seed;
+    uint64_t mixed = splitmix64(x) ^ (stream * 0xD1B54A32D192ED03ULL);
+
+    for (unsigned int i = 0; i < 4; ++i)
+        this->s[i] = splitmix64(mixed);
+}
+
+const uint64_t *Random::getState()
+{
+    return this->s;
+}
+
+void Random::setState(const uint64_t *state)
+{
+    for (unsigned int i = 0; i < 4; ++i)
+        this->s[i] = state[i];
+}
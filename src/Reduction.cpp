@@ -0,0 +1,236 @@
+#include "Reduction.h"
+
+Reduction::Reduction(Graph &graph, unsigned int k)
+{
+    this->vertex_count = graph.getVertexCount();
+
+    // Input files may list an edge twice
+    this->adjacent.resize(this->vertex_count);
+    std::vector<unsigned int> degree(this->vertex_count);
+
+    for (unsigned int u = 0; u < this->vertex_count; ++u)
+    {
+        this->adjacent[u] = graph.getVertex(u)->getAdjacent();
+        std::sort(this->adjacent[u].begin(), this->adjacent[u].end());
+        this->adjacent[u].erase(std::unique(this->adjacent[u].begin(), this->adjacent[u].end()), this->adjacent[u].end());
+        degree[u] = this->adjacent[u].size();
+    }
+
+    std::vector<bool> present(this->vertex_count, true);
+    this->dominator.assign(this->vertex_count, -1);
+
+    // Peel low degree vertexes, then dominated ones, until nothing changes
+    unsigned int threshold = k > 1 ? k - 1 : 0;
+    bool changed = true;
+
+    while (changed)
+    {
+        std::vector<unsigned int> peel;
+        for (unsigned int u = 0; u < this->vertex_count; ++u)
+            if (present[u] && degree[u] < threshold)
+                peel.push_back(u);
+
+        while (!peel.empty())
+        {
+            unsigned int u = peel.back();
+            peel.pop_back();
+
+            if (!present[u])
+                continue;
+
+            this->remove(u, -1, present, degree);
+
+            // Neighbors whose degree dropped below the threshold
+            for (auto v = this->adjacent[u].begin(); v != this->adjacent[u].end(); ++v)
+                if (present[*v] && degree[*v] == threshold - 1)
+                    peel.push_back(*v);
+        }
+
+        changed = this->removeDominated(present, degree);
+    }
+
+    // Build the reduced graph from the remaining vertexes
+    std::vector<unsigned int> renumbered(this->vertex_count, -1);
+    for (unsigned int u = 0; u < this->vertex_count; ++u)
+    {
+        if (present[u])
+        {
+            renumbered[u] = this->kept.size();
+            this->kept.push_back(u);
+        }
+    }
+
+    std::vector<unsigned int> edges;
+    for (auto u = this->kept.begin(); u != this->kept.end(); ++u)
+    {
+        for (auto v = this->adjacent[*u].begin(); v != this->adjacent[*u].end(); ++v)
+        {
+            if (present[*v] && *u < *v)
+            {
+                edges.push_back(renumbered[*u]);
+                edges.push_back(renumbered[*v]);
+            }
+        }
+    }
+
+    this->reduced = new Graph(this->kept.size(), edges.data(), edges.size() / 2);
+}
+
+Reduction::~Reduction()
+{
+    delete this->reduced;
+}
+
+void Reduction::remove(unsigned int vertex, unsigned int by, std::vector<bool> &present, std::vector<unsigned int> &degree)
+{
+    present[vertex] = false;
+    this->removed.push_back(vertex);
+    this->dominator[vertex] = by;
+
+    for (auto v = this->adjacent[vertex].begin(); v != this->adjacent[vertex].end(); ++v)
+        if (present[*v])
+            degree[*v]--;
+}
+
+bool Reduction::removeDominated(std::vector<bool> &present, std::vector<unsigned int> &degree)
+{
+    // One adjacency bitset row per vertex, graphs too large for them are
+    // checked on the sorted adjacency lists instead
+    unsigned long words = (this->vertex_count + 63) / 64;
+    bool bitsets = words * this->vertex_count * sizeof(uint64_t) <= MAX_BITSET_BYTES;
+
+    std::vector<uint64_t> rows(bitsets ? words * this->vertex_count : 0, 0);
+    for (unsigned int u = 0; bitsets && u < this->vertex_count; ++u)
+        if (present[u])
+            for (auto v = this->adjacent[u].begin(); v != this->adjacent[u].end(); ++v)
+                if (present[*v])
+                    rows[u * words + *v / 64] |= 1ull << (*v % 64);
+
+    bool changed = false;
+
+    for (unsigned int u = 0; u < this->vertex_count; ++u)
+    {
+        if (!present[u] || degree[u] == 0)
+            continue;
+
+        // A dominating vertex is adjacent to every neighbor of u, so it is
+        // a neighbor of u's lowest degree neighbor
+        unsigned int pivot = -1;
+        for (auto w = this->adjacent[u].begin(); w != this->adjacent[u].end(); ++w)
+            if (present[*w] && (pivot == (unsigned int)-1 || degree[*w] < degree[pivot]))
+                pivot = *w;
+
+        const uint64_t *row_u = bitsets ? &rows[u * words] : NULL;
+
+        for (auto v = this->adjacent[pivot].begin(); v != this->adjacent[pivot].end(); ++v)
+        {
+            if (*v == u || !present[*v] || degree[*v] < degree[u])
+                continue;
+
+            if (bitsets ? (row_u[*v / 64] >> (*v % 64)) & 1 : std::binary_search(this->adjacent[u].begin(), this->adjacent[u].end(), *v))
+                continue;
+
+            // N(u) is a subset of N(v)
+            bool dominated = true;
+            if (bitsets)
+            {
+                const uint64_t *row_v = &rows[*v * words];
+                for (unsigned long i = 0; dominated && i < words; ++i)
+                    dominated = (row_u[i] & ~row_v[i]) == 0;
+            }
+            else
+            {
+                dominated = this->contains(*v, u, present);
+            }
+
+            if (dominated)
+            {
+                this->remove(u, *v, present, degree);
+
+                // Clear u from its neighbors' rows
+                for (auto w = this->adjacent[u].begin(); bitsets && w != this->adjacent[u].end(); ++w)
+                    rows[*w * words + u / 64] &= ~(1ull << (u % 64));
+
+                changed = true;
+                break;
+            }
+        }
+    }
+
+    return changed;
+}
+
+bool Reduction::contains(unsigned int v, unsigned int u, const std::vector<bool> &present)
+{
+    // Both lists are sorted, a single merge pass
+    auto w = this->adjacent[v].begin();
+
+    for (auto x = this->adjacent[u].begin(); x != this->adjacent[u].end(); ++x)
+    {
+        if (!present[*x])
+            continue;
+
+        while (w != this->adjacent[v].end() && *w < *x)
+            ++w;
+
+        if (w == this->adjacent[v].end() || *w != *x)
+            return false;
+    }
+
+    return true;
+}
+
+Graph &Reduction::getReduced()
+{
+    return *this->reduced;
+}
+
+unsigned int Reduction::getRemovedCount()
+{
+    return this->removed.size();
+}
+
+void Reduction::restrict(Snapshot &full, Snapshot &reduced_coloring)
+{
+    std::vector<unsigned int> coloring(this->kept.size());
+
+    for (unsigned int i = 0; i < this->kept.size(); ++i)
+        coloring[i] = full.getColor(this->kept[i]);
+
+    reduced_coloring.assign(coloring);
+}
+
+void Reduction::expand(Snapshot &reduced_coloring, Snapshot &full)
+{
+    std::vector<unsigned int> coloring(this->vertex_count, -1);
+
+    for (unsigned int i = 0; i < this->kept.size(); ++i)
+        coloring[this->kept[i]] = reduced_coloring.getColor(i);
+
+    // Colors used by the neighbors of the vertex being colored back
+    std::vector<unsigned int> marks(this->vertex_count + 1, -1);
+
+    for (auto u = this->removed.rbegin(); u != this->removed.rend(); ++u)
+    {
+        for (auto v = this->adjacent[*u].begin(); v != this->adjacent[*u].end(); ++v)
+            if (coloring[*v] != (unsigned int)-1)
+                marks[coloring[*v]] = *u;
+
+        // A dominated vertex can share its dominator's color, otherwise
+        // take the smallest free color
+        unsigned int by = this->dominator[*u];
+        if (by != (unsigned int)-1 && marks[coloring[by]] != *u)
+        {
+            coloring[*u] = coloring[by];
+        }
+        else
+        {
+            unsigned int color = 0;
+            while (marks[color] == *u)
+                color++;
+            coloring[*u] = color;
+        }
+    }
+
+    full.assign(coloring);
+}
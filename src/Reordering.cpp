@@ -0,0 +1,139 @@
+#include "Reordering.h"
+
+Reordering::Reordering(Graph &graph, VertexOrder vertex_order)
+{
+    unsigned int vertex_count = graph.getVertexCount();
+
+    switch (vertex_order)
+    {
+    case ORDER_DEGREE:
+        this->order.resize(vertex_count);
+        for (unsigned int u = 0; u < vertex_count; ++u)
+            this->order[u] = u;
+        std::stable_sort(this->order.begin(), this->order.end(), [&graph](unsigned int a, unsigned int b) {
+            return graph.getVertex(a)->getAdjacent().size() > graph.getVertex(b)->getAdjacent().size();
+        });
+        break;
+    case ORDER_BFS:
+        this->breadthFirst(graph, false);
+        break;
+    case ORDER_RCM:
+        this->breadthFirst(graph, true);
+        std::reverse(this->order.begin(), this->order.end());
+        break;
+    default:
+        this->order.resize(vertex_count);
+        for (unsigned int u = 0; u < vertex_count; ++u)
+            this->order[u] = u;
+        break;
+    }
+
+    // Inverse permutation
+    this->position.resize(vertex_count);
+    for (unsigned int i = 0; i < vertex_count; ++i)
+        this->position[this->order[i]] = i;
+
+    // Renumbered graph, vertexes added in the new order
+    std::vector<unsigned int> edges;
+    for (unsigned int i = 0; i < vertex_count; ++i)
+    {
+        const std::vector<unsigned int> &adjacent = graph.getVertex(this->order[i])->getAdjacent();
+        for (auto v = adjacent.begin(); v != adjacent.end(); ++v)
+        {
+            if (i < this->position[*v])
+            {
+                edges.push_back(i);
+                edges.push_back(this->position[*v]);
+            }
+        }
+    }
+
+    this->permuted = new Graph(vertex_count, edges.data(), edges.size() / 2);
+}
+
+Reordering::~Reordering()
+{
+    delete this->permuted;
+}
+
+void Reordering::breadthFirst(Graph &graph, bool by_degree)
+{
+    unsigned int vertex_count = graph.getVertexCount();
+
+    auto degree = [&graph](unsigned int u) { return graph.getVertex(u)->getAdjacent().size(); };
+
+    // Component roots are taken by increasing degree
+    std::vector<unsigned int> roots(vertex_count);
+    for (unsigned int u = 0; u < vertex_count; ++u)
+        roots[u] = u;
+    std::stable_sort(roots.begin(), roots.end(), [&degree](unsigned int a, unsigned int b) { return degree(a) < degree(b); });
+
+    std::vector<bool> visited(vertex_count, false);
+    this->order.clear();
+    this->order.reserve(vertex_count);
+
+    for (auto root = roots.begin(); root != roots.end(); ++root)
+    {
+        if (visited[*root])
+            continue;
+
+        visited[*root] = true;
+        this->order.push_back(*root);
+
+        // The order itself is the queue
+        for (unsigned int head = this->order.size() - 1; head < this->order.size(); ++head)
+        {
+            unsigned int first = this->order.size();
+
+            const std::vector<unsigned int> &adjacent = graph.getVertex(this->order[head])->getAdjacent();
+            for (auto v = adjacent.begin(); v != adjacent.end(); ++v)
+            {
+                if (!visited[*v])
+                {
+                    visited[*v] = true;
+                    this->order.push_back(*v);
+                }
+            }
+
+            if (by_degree)
+                std::stable_sort(this->order.begin() + first, this->order.end(), [&degree](unsigned int a, unsigned int b) { return degree(a) < degree(b); });
+        }
+    }
+}
+
+Graph &Reordering::getPermuted()
+{
+    return *this->permuted;
+}
+
+void Reordering::permute(Snapshot &original, Snapshot &renumbered)
+{
+    std::vector<unsigned int> coloring(this->order.size());
+
+    for (unsigned int i = 0; i < this->order.size(); ++i)
+        coloring[i] = original.getColor(this->order[i]);
+
+    renumbered.assign(coloring);
+}
+
+void Reordering::restore(std::vector<unsigned int> &coloring)
+{
+    std::vector<unsigned int> renumbered(coloring);
+
+    for (unsigned int i = 0; i < this->order.size(); ++i)
+        coloring[this->order[i]] = renumbered[i];
+}
+
+VertexOrder Reordering::parse(std::string name)
+{
+    if (name == "input")
+        return ORDER_INPUT;
+    if (name == "degree")
+        return ORDER_DEGREE;
+    if (name == "bfs")
+        return ORDER_BFS;
+    if (name == "rcm")
+        return ORDER_RCM;
+
+    throw std::runtime_error("Unknown vertex order '" + name + "'!");
+}
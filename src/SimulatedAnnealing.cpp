@@ -1,75 +1,215 @@
 #include "SimulatedAnnealing.h"
 
-SimulatedAnnealing::SimulatedAnnealing(double t, double k, double r, unsigned int max_neighbors, unsigned int max_iterations, std::string filename) : G(filename)
+std::string Progress::toJson() const
+{
+    std::stringstream json;
+
+    json << "{\"iteration\": " << this->iteration
+         << ", \"temperature\": " << this->temperature
+         << ", \"current_value\": " << this->current_value
+         << ", \"best_value\": " << this->best_value
+         << ", \"accepted\": " << this->accepted
+         << ", \"evaluated\": " << this->evaluated
+         << ", \"elapsed_seconds\": " << this->elapsed_seconds
+         << ", \"finished\": " << (this->finished ? "true" : "false")
+         << ", \"best_iteration\": " << this->best_iteration
+         << ", \"best_seconds\": " << this->best_seconds << "}";
+
+    return json.str();
+}
+
+// Creates a run with the given index width and policies
+typedef SimulatedAnnealing *(*RunFactory)(Graph &, Random, double, double, double, unsigned int, unsigned int, const AnnealingPolicies &);
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+static SimulatedAnnealing *createRun(Graph &graph, Random random, double t, double k, double r, unsigned int max_neighbors, unsigned int max_iterations, const AnnealingPolicies &policies)
+{
+    return new BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>(graph, random, t, k, r, max_neighbors, max_iterations, policies);
+}
+
+// Factories of every policy combination, by AnnealingPolicies::getKey(),
+// for 16 and 32 bit indexes
+typedef std::map<std::string, std::pair<RunFactory, RunFactory>> RunRegistry;
+
+template <typename Moves, typename Acceptance, typename Schedule>
+static void registerRun(RunRegistry &registry)
+{
+    AnnealingPolicies policies;
+    policies.moves = Moves::NAME;
+    policies.acceptance = Acceptance::NAME;
+    policies.schedule = Schedule::NAME;
+
+    registry[policies.getKey()] = std::make_pair(&createRun<uint16_t, Moves, Acceptance, Schedule>,
+                                                 &createRun<uint32_t, Moves, Acceptance, Schedule>);
+}
+
+template <typename Moves, typename Acceptance>
+static void registerSchedules(RunRegistry &registry)
+{
+    registerRun<Moves, Acceptance, GeometricCooling>(registry);
+    registerRun<Moves, Acceptance, LinearCooling>(registry);
+    registerRun<Moves, Acceptance, LundyMeesCooling>(registry);
+    registerRun<Moves, Acceptance, AdaptiveCooling>(registry);
+}
+
+template <typename Moves>
+static void registerAcceptances(RunRegistry &registry)
+{
+    registerSchedules<Moves, MetropolisAcceptance>(registry);
+    registerSchedules<Moves, ThresholdAcceptance>(registry);
+    registerSchedules<Moves, LateAcceptance>(registry);
+}
+
+static const RunRegistry &getRegistry()
+{
+    static RunRegistry registry;
+    static std::once_flag once;
+
+    std::call_once(once, []() {
+        registerAcceptances<MixedMoves>(registry);
+        registerAcceptances<RecolorMoves>(registry);
+    });
+
+    return registry;
+}
+
+SimulatedAnnealing *SimulatedAnnealing::create(Graph &graph, Random random, double t, double k, double r, unsigned int max_neighbors, unsigned int max_iterations, const AnnealingPolicies &policies)
+{
+    SimulatedAnnealing::checkPolicies(policies);
+
+    if (graph.getVertexCount() == 0)
+        throw std::runtime_error("Graph has no vertexes!");
+
+    const std::pair<RunFactory, RunFactory> &factories = getRegistry().at(policies.getKey());
+
+    // Narrowest index width that fits the graph
+    if (fitsIndex<uint16_t>(graph.getVertexCount()))
+        return factories.first(graph, random, t, k, r, max_neighbors, max_iterations, policies);
+
+    return factories.second(graph, random, t, k, r, max_neighbors, max_iterations, policies);
+}
+
+void SimulatedAnnealing::checkPolicies(const AnnealingPolicies &policies)
+{
+    if (getRegistry().count(policies.getKey()) == 0)
+        throw std::runtime_error("Unknown annealing policies '" + policies.getKey() + "'!");
+    if (policies.objective != "colors" && policies.objective != "class-sizes")
+        throw std::runtime_error("Unknown objective '" + policies.objective + "'!");
+}
+
+SimulatedAnnealing::~SimulatedAnnealing()
+{
+    // nil
+}
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::BasicSimulatedAnnealing(Graph &graph, Random random, double t, double k, double r, unsigned int max_neighbors, unsigned int max_iterations, const AnnealingPolicies &policies)
+    : G(graph), rng(random), elite(ELITE_SIZE, graph.getVertexCount()), objective(policies),
+      moves(PolicyParameters{t, k, r, max_iterations, policies.history_length, policies.initial_acceptance, policies.stagnation_steps, policies.max_reheats}),
+      acceptance(PolicyParameters{t, k, r, max_iterations, policies.history_length, policies.initial_acceptance, policies.stagnation_steps, policies.max_reheats}),
+      schedule(PolicyParameters{t, k, r, max_iterations, policies.history_length, policies.initial_acceptance, policies.stagnation_steps, policies.max_reheats})
 {
     this->temperature = t;
-    this->cooling_factor = r;
     this->constant_k = k;
     this->max_iterations = max_iterations;
     this->max_neighbors = max_neighbors;
 
-    // File for GLPK-ready output
-    std::ofstream data("data.dat");
+    this->verbose = false;
+
+    this->checkpoint_interval = 0;
+    this->checkpoint_writer = NULL;
+    this->graph_hash = 0;
+    this->resume_checkpoint = NULL;
+    this->initial_coloring = NULL;
+
+    this->started = false;
+    this->finished = false;
+    this->cancelled = false;
+    this->current_state = NULL;
+    this->pool = NULL;
+    this->iteration_number = 1;
+    this->prob_kt = 0;
+    this->last_accepted = 0;
+
+    this->correct = false;
+    this->iterations = 0;
+    this->elapsed_seconds = 0;
+    this->best_iteration = 0;
+    this->best_seconds = 0;
+}
 
-    // Write output file opening statement
-    data << "data;" << std::endl
-         << std::endl;
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::~BasicSimulatedAnnealing()
+{
+    // Free states of an unfinished run
+    if (this->pool != NULL)
+        delete this->pool;
+
+    if (this->checkpoint_writer != NULL)
+        delete this->checkpoint_writer;
+    if (this->resume_checkpoint != NULL)
+        delete this->resume_checkpoint;
+    if (this->initial_coloring != NULL)
+        delete this->initial_coloring;
+}
 
-    // Write big M
-    data << "# Big M parameter" << std::endl;
-    data << "param M := " << this->G.getVertexCount() << std::endl;
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::setVerbose(bool enabled)
+{
+    this->verbose = enabled;
+}
 
-    // Write vertex set
-    data << "# Vertex set (Numbered 0 through N-1)" << std::endl;
-    data << "set V :=";
-    for (unsigned int i = 0; i < this->G.getVertexCount(); i++)
-    {
-        data << " " << i;
-    }
-    data << ";" << std::endl
-         << std::endl;
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::setLogFiles(std::string log, std::string neighbors)
+{
+    this->log_filename = log;
+    this->neighbors_filename = neighbors;
+}
 
-    // Write color set
-    data << "# Color set (Assuming worst case scenario where nColors = nVertexes)" << std::endl;
-    data << "set C :=";
-    for (unsigned int i = 0; i < this->G.getVertexCount(); i++)
-    {
-        data << " " << i;
-    }
-    data << ";" << std::endl
-         << std::endl;
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::setProgressCallback(std::function<void(const Progress &)> callback)
+{
+    this->progress_callback = callback;
+}
 
-    // Write adjacency matrix
-    data << "# Graph adjacency matrix" << std::endl;
-    data << "param graph :=" << std::endl;
-    for (unsigned int i = 0; i < this->G.getVertexCount(); i++)
-    {
-        for (unsigned int j = 0; j < this->G.getVertexCount(); j++)
-        {
-            data << " [" << i << ", " << j << "] " << this->G.getVertex(i)->isAdjacentTo(j);
-            if (i < this->G.getVertexCount() - 1 || j < this->G.getVertexCount() - 1)
-            {
-                data << ",";
-            }
-        }
-        data << std::endl;
-    }
-    data << ";" << std::endl
-         << std::endl;
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::setCheckpoint(std::string filename, unsigned long interval)
+{
+    this->checkpoint_filename = filename;
+    this->checkpoint_interval = interval;
+}
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::resume(Checkpoint &checkpoint)
+{
+    if (checkpoint.vertex_count != this->G.getVertexCount() || checkpoint.edge_count != this->G.getEdgeCount() ||
+        checkpoint.graph_hash != this->G.getCanonicalHash() || !checkpoint.current.fits(this->G.getVertexCount()) || !checkpoint.best.fits(this->G.getVertexCount()))
+        throw std::runtime_error("Checkpoint does not match the input graph!");
 
-    // Write output file closing statement
-    data << "end;" << std::endl;
+    // The acceptance rule and the schedule continue from their saved state
+    if (!this->acceptance.restore(checkpoint.acceptance_state) || !this->schedule.restore(checkpoint.schedule_state))
+        throw std::runtime_error("Checkpoint does not match the annealing policies!");
 
-    // Close file
-    data.close();
+    if (this->resume_checkpoint == NULL)
+        this->resume_checkpoint = new Checkpoint();
+
+    *this->resume_checkpoint = checkpoint;
 }
 
-SimulatedAnnealing::~SimulatedAnnealing()
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::setInitialColoring(Snapshot &coloring)
 {
-    // nil
+    if (coloring.getVertexCount() != this->G.getVertexCount())
+        throw std::runtime_error("Initial coloring does not match the input graph!");
+
+    if (this->initial_coloring == NULL)
+        this->initial_coloring = new Snapshot();
+
+    this->initial_coloring->copyFrom(coloring);
 }
 
-void SimulatedAnnealing::run()
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::run()
 {
     /**
      * Pseudo-Algorithm:
@@ -85,141 +225,423 @@ void SimulatedAnnealing::run()
      * 9. return s
      */
 
-    double prob_kt = 0;        // Probability that a worse state will be chosen
-    uint iteration_number = 1; // Current iteration number
-
-    std::vector<State *> neighbors;
-    State *neighbor = NULL; // Generated neighbor for a state
+    while (this->step(this->max_iterations))
+        ;
+}
 
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+bool BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::step(unsigned long n_iterations)
+{
     double lambda = 0.00000001; // Lower limit for temperature before stopping
 
-    // Log files
-    std::ofstream log_file("log.dat");
-    std::ofstream neigh_file("neighbors.dat");
+    if (this->finished)
+        return false;
+
+    // Measure time spent in this step
+    this->step_start = std::chrono::steady_clock::now();
+
+    if (!this->started)
+        this->start();
+
+    // While temperature is not 0 and iterations remain (STOP 2)
+    for (unsigned long i = 0; i < n_iterations && !this->cancelled &&
+                              this->temperature > lambda && this->iteration_number <= this->max_iterations;
+         ++i)
+        this->iterate();
+
+    this->elapsed_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - this->step_start).count();
+    this->step_start = std::chrono::steady_clock::now();
+
+    if (this->cancelled || this->temperature <= lambda || this->iteration_number > this->max_iterations)
+        this->finish();
+
+    return !this->finished;
+}
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::cancel()
+{
+    this->cancelled = true;
+}
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+bool BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::isFinished()
+{
+    return this->finished;
+}
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+Progress BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::getProgress()
+{
+    Progress progress;
+
+    progress.iteration = this->iteration_number - 1;
+    progress.temperature = this->temperature;
+    progress.current_value = this->current_state != NULL ? this->current_state->getValue() : this->best.getValue();
+    progress.best_value = this->best.getValue();
+    progress.accepted = this->last_accepted;
+    progress.evaluated = this->started ? this->max_neighbors : 0;
+    progress.elapsed_seconds = this->elapsed_seconds;
+    if (this->started && !this->finished)
+        progress.elapsed_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - this->step_start).count();
+    progress.finished = this->finished;
+    progress.best_iteration = this->best_iteration;
+    progress.best_seconds = this->best_seconds;
+
+    return progress;
+}
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::start()
+{
+    // Log files, only opened when enabled
+    if (!this->log_filename.empty())
+        this->log_file.open(this->log_filename);
+    if (!this->neighbors_filename.empty())
+        this->neigh_file.open(this->neighbors_filename);
 
     // Output information
-    std::cout << "[INFO]: Generating starting state..." << std::endl;
+    if (this->verbose)
+        std::cout << "[INFO]: Generating starting state..." << std::endl;
+
+    BasicState<Index> *starting_state = NULL;
+    bool resumed = this->resume_checkpoint != NULL;
+
+    if (resumed)
+    {
+        // Continue where the checkpointed run stopped
+        starting_state = BasicState<Index>::fromSnapshot(this->G, this->resume_checkpoint->current);
+        this->best.copyFrom(this->resume_checkpoint->best);
+        this->temperature = this->resume_checkpoint->temperature;
+        this->iteration_number = this->resume_checkpoint->iteration_number;
+        this->elapsed_seconds = this->resume_checkpoint->elapsed_seconds;
+        this->rng.setState(this->resume_checkpoint->rng_state);
+
+        // Checkpoints do not record when the best state was found
+        this->best_iteration = this->iteration_number - 1;
+        this->best_seconds = this->elapsed_seconds;
+
+        delete this->resume_checkpoint;
+        this->resume_checkpoint = NULL;
+    }
+    else
+    {
+        // Generate starting state, or use the given one
+        if (this->initial_coloring != NULL)
+        {
+            starting_state = BasicState<Index>::fromSnapshot(this->G, *this->initial_coloring);
+
+            delete this->initial_coloring;
+            this->initial_coloring = NULL;
+
+            if (!starting_state->checkCorrectness())
+            {
+                delete starting_state;
+                throw std::runtime_error("Initial coloring is not valid!");
+            }
+        }
+        else
+            starting_state = BasicState<Index>::generateStartingState(this->G, this->rng);
+
+        // Update best state
+        this->best.capture(starting_state->getGraph(), starting_state->getValue());
+    }
+
+    // Pool of recycled states, sized for every neighbor, the current state and a spare
+    this->pool = new BasicStatePool<Index>(starting_state, this->max_neighbors + 2);
+    this->current_state = this->pool->acquire(starting_state);
+    delete starting_state;
+
+    this->neighbors.reserve(this->max_neighbors);
+
+    // Initial temperature from the value increases of random neighbors,
+    // resumed runs keep theirs
+    if (Schedule::CALIBRATION_SAMPLES > 0 && !resumed)
+    {
+        std::vector<double> increases;
+        increases.reserve(Schedule::CALIBRATION_SAMPLES);
+
+        double current_cost = this->objective.cost(this->current_state);
+
+        for (unsigned int i = 0; i < Schedule::CALIBRATION_SAMPLES; ++i)
+        {
+            BasicState<Index> *sample = this->pool->acquire(this->current_state);
+            this->moves.apply(sample, this->rng);
+
+            double sample_cost = this->objective.cost(sample);
+            if (sample_cost > current_cost)
+                increases.push_back(sample_cost - current_cost);
+
+            this->pool->release(sample);
+        }
+
+        this->temperature = this->schedule.calibrate(this->temperature, increases);
+
+        if (this->verbose)
+            std::cout << "[INFO]: Initial temperature: " << this->temperature << std::endl;
+    }
+
+    if (this->checkpoint_interval > 0)
+    {
+        this->checkpoint_writer = new CheckpointWriter(this->checkpoint_filename, this->G.getVertexCount());
+        this->graph_hash = this->G.getCanonicalHash();
+    }
+
+    if (this->verbose)
+        std::cout << "[INFO]: Done." << std::endl;
 
-    // Start measuring time
-    auto start = std::chrono::system_clock::now();
+    this->started = true;
+}
 
-    // Generate starting state
-    State *current_state = State::generateStartingState(this->G);
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::iterate()
+{
+    BasicState<Index> *neighbor = NULL; // Generated neighbor for a state
 
-    std::cout << "[INFO]: Done." << std::endl;
+    // Every buffer has been allocated once the first iteration is over
+    if (this->iteration_number == 2)
+        INSTRUMENT_STEADY_STATE_BEGIN();
 
-    // While temperature is not 0 (STOP 2)
-    while (this->temperature > lambda)
+    // Log
     {
+        INSTRUMENT_PHASE(PHASE_LOGGING);
+        if (this->verbose)
+        {
+            std::cout << "========================================================" << std::endl;
+            std::cout << "[INFO]: Iteration: " << this->iteration_number << std::endl;
+            std::cout << "[INFO]: Temperature: " << this->temperature << std::endl;
+            std::cout << "[INFO]: Selection probability denominator (k*t): " << this->prob_kt << std::endl;
+            std::cout << "[INFO]: Current state value: " << this->current_state->getValue() << std::endl;
+        }
+        if (this->log_file.is_open())
+            this->log_file << this->iteration_number << "  " << this->current_state->getValue() << std::endl;
+    }
+
+    // Calculate new selection probability denominator with new temperature
+    this->prob_kt = this->constant_k * this->temperature;
+
+    // What happens during this temperature step, for the schedule
+    StepFeedback step = StepFeedback();
+    step.iteration_number = this->iteration_number;
+    step.evaluated = this->max_neighbors;
+
+    this->neighbors.clear();
+    for (unsigned int i = 0; i < this->max_neighbors; ++i)
+    {
+        {
+            INSTRUMENT_PHASE(PHASE_NEIGHBOR_GENERATION);
+
+            // New neighbor with the same graph as the current state
+            neighbor = this->pool->acquire(this->current_state);
+            this->moves.apply(neighbor, this->rng);
+        }
+
+        // If better than best, update best
+        if (neighbor->getValue() < this->best.getValue())
+        {
+            this->best.capture(neighbor->getGraph(), neighbor->getValue());
+            this->best_iteration = this->iteration_number;
+            this->best_seconds = this->elapsed_seconds + std::chrono::duration<double>(std::chrono::steady_clock::now() - this->step_start).count();
+            step.improved = true;
+            INSTRUMENT_COUNT(COUNTER_BEST_IMPROVEMENTS);
+        }
+
+        this->neighbors.push_back(neighbor);
+    }
+
+    // Neighbors accepted during this temperature step
+    unsigned int accepted = 0;
+
+    // Iterate neighbors (STOP 1)
+    for (unsigned int i = 0; i < this->max_neighbors; ++i)
+    {
+        // Get neighbor
+        neighbor = this->neighbors[i];
+
         // Log
-        std::cout << "========================================================" << std::endl;
-        std::cout << "[INFO]: Iteration: " << iteration_number << std::endl;
-        std::cout << "[INFO]: Temperature: " << this->temperature << std::endl;
-        std::cout << "[INFO]: Selection probability denominator (k*t): " << prob_kt << std::endl;
-        std::cout << "[INFO]: Current state value: " << current_state->getValue() << std::endl;
-        log_file << iteration_number << "  " << current_state->getValue() << std::endl;
-
-        // Calculate new selection probability denominator with new temperature
-        prob_kt = this->constant_k * this->temperature;
-
-        neighbors.clear();
-        for (unsigned int i = 0; i < this->max_neighbors; ++i)
         {
-            neighbor = current_state->generateNeighbor(iteration_number, this->temperature);
-            neighbors.push_back(neighbor);
+            INSTRUMENT_PHASE(PHASE_LOGGING);
+            if (this->neigh_file.is_open())
+                this->neigh_file << this->iteration_number << "  " << neighbor->getValue() << std::endl;
         }
 
-        // Iterate neighbors (STOP 1)
-        for (unsigned int i = 0; i < this->max_neighbors; ++i)
+        BasicState<Index> *discarded = NULL; // State that is no longer needed
+
         {
-            // Get neighbor
-            neighbor = neighbors[i];
+            INSTRUMENT_PHASE(PHASE_ACCEPTANCE);
 
-            // Log
-            neigh_file << iteration_number << "  " << neighbor->getValue() << std::endl;
+            double current_cost = this->objective.cost(this->current_state);
+            double neighbor_cost = this->objective.cost(neighbor);
+            bool uphill = neighbor_cost > current_cost;
 
-            // If neighbor value is better than current value
-            if (neighbor->getValue() <= current_state->getValue())
+            if (uphill)
+                step.uphill_evaluated++;
+
+            if (this->acceptance.accept(current_cost, neighbor_cost, this->prob_kt, this->rng))
             {
                 // Update current state
-                delete current_state;
-                current_state = neighbor;
+                discarded = this->current_state;
+                this->current_state = neighbor;
+                accepted++;
+
+                if (uphill)
+                {
+                    step.uphill_accepted++;
+                    INSTRUMENT_COUNT(COUNTER_UPHILL);
+                }
             }
             else
             {
-                // With 1.0e-((f(s') - f(s))/k*t) probability
-                if (random() / RAND_MAX < std::exp(-(double)(neighbor->getValue() - current_state->getValue()) / prob_kt))
-                {
-                    // Assign worse state anyways
-                    delete current_state;
-                    current_state = neighbor;
-                }
-                else
-                {
-                    // If neighbor was ignored, delete it
-                    delete neighbor;
-                }
+                // If neighbor was ignored, delete it
+                discarded = neighbor;
             }
         }
-        neigh_file << std::endl;
 
-        // Decrease temperature
-        this->temperature = this->temperature * this->cooling_factor;
+        // Recycle discarded state
+        {
+            INSTRUMENT_PHASE(PHASE_DELETION);
+            this->pool->release(discarded);
+        }
+    }
+    if (this->neigh_file.is_open())
+        this->neigh_file << std::endl;
+
+    this->last_accepted = accepted;
+    step.accepted = accepted;
+
+    INSTRUMENT_COUNT_N(COUNTER_ACCEPTED, accepted);
+    INSTRUMENT_COUNT_N(COUNTER_REJECTED, this->max_neighbors - accepted);
+    INSTRUMENT_BAND(this->temperature, accepted, this->max_neighbors);
+
+    // Keep the best distinct states visited for restarts
+    if (this->elite.accepts(this->current_state->getValue()))
+        this->elite.offer(this->current_state->getGraph(), this->current_state->getValue());
+
+    // Report progress
+    if (this->progress_callback)
+        this->progress_callback(this->getProgress());
 
-        // Increment iteration
-        iteration_number++;
+    // Decrease temperature
+    this->temperature = this->schedule.cool(this->temperature, step);
+
+    // Increment iteration
+    this->iteration_number++;
+
+    // Save the position of the run
+    if (this->checkpoint_writer != NULL && this->iteration_number % this->checkpoint_interval == 0)
+        this->checkpoint();
+}
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::checkpoint()
+{
+    // Skipped while the previous checkpoint is pending
+    Checkpoint *checkpoint = this->checkpoint_writer->stage();
+    if (checkpoint == NULL)
+        return;
+
+    checkpoint->vertex_count = this->G.getVertexCount();
+    checkpoint->edge_count = this->G.getEdgeCount();
+    checkpoint->graph_hash = this->graph_hash;
+    checkpoint->iteration_number = this->iteration_number;
+    checkpoint->temperature = this->temperature;
+    checkpoint->elapsed_seconds = this->elapsed_seconds + std::chrono::duration<double>(std::chrono::steady_clock::now() - this->step_start).count();
+    std::memcpy(checkpoint->rng_state, this->rng.getState(), sizeof(checkpoint->rng_state));
+    this->acceptance.save(checkpoint->acceptance_state);
+    this->schedule.save(checkpoint->schedule_state);
+    checkpoint->current.capture(this->current_state->getGraph(), this->current_state->getValue());
+    checkpoint->best.copyFrom(this->best);
+
+    this->checkpoint_writer->submit();
+}
+
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+void BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::finish()
+{
+    INSTRUMENT_STEADY_STATE_END();
+
+    // Write the final position and wait for the writer
+    if (this->checkpoint_writer != NULL)
+    {
+        while (this->checkpoint_writer->stage() == NULL)
+            std::this_thread::yield();
+        this->checkpoint();
+
+        delete this->checkpoint_writer;
+        this->checkpoint_writer = NULL;
     }
 
-    // Stop timer
-    auto end = std::chrono::system_clock::now();
-    std::chrono::duration<double> elapsed_seconds = end - start;
+    // Recycle current state and free the pool
+    unsigned long extra_allocations = this->pool->getExtraAllocations();
+    this->pool->release(this->current_state);
+    this->current_state = NULL;
+    delete this->pool;
+    this->pool = NULL;
 
-    // Free memory
-    delete current_state;
+    // Store results
+    this->iterations = this->iteration_number - 1;
+    this->finished = true;
 
-    // Get best state
-    current_state = State::getBest();
+    // Build best state from the stored coloring
+    BasicState<Index> *best_state = BasicState<Index>::fromSnapshot(this->G, this->best);
 
     // Check if final state is correct
-    current_state->checkCorrectness();
+    this->correct = best_state->checkCorrectness();
 
-    // Best state
-    std::cout << "[INFO]: Best found state uses " << current_state->getValue() << " colors" << std::endl;
-    std::cout << current_state->toString() << std::endl;
+    if (this->verbose)
+    {
+        // Best state
+        std::cout << "[INFO]: Best found state uses " << best_state->getValue() << " colors" << std::endl;
+        std::cout << best_state->toString() << std::endl;
 
-    // Log
-    std::cout << "[INFO]: Finished in " << elapsed_seconds.count() << " seconds" << std::endl
-              << "[INFO]: Total iterations: " << iteration_number - 1 << std::endl;
+        // Log
+        std::cout << "[INFO]: Finished in " << this->elapsed_seconds << " seconds" << std::endl
+                  << "[INFO]: Total iterations: " << this->iterations << std::endl
+                  << "[INFO]: Best found at iteration " << this->best_iteration << ", after " << this->best_seconds << " seconds" << std::endl
+                  << "[INFO]: States allocated after pool creation: " << extra_allocations << std::endl;
+
+        std::cout << "[INFO]: Elite pool values:";
+        for (unsigned int i = 0; i < this->elite.getSize(); ++i)
+            std::cout << " " << this->elite.get(i)->getValue();
+        std::cout << std::endl;
+    }
 
     // Close log files
-    log_file.close();
-    neigh_file.close();
+    if (this->log_file.is_open())
+        this->log_file.close();
+    if (this->neigh_file.is_open())
+        this->neigh_file.close();
 
     // Free memory
-    delete current_state;
-
-    // Return
-    return;
+    delete best_state;
 }
 
-int main(int argc, char **argv)
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+Snapshot *BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::getBest()
 {
-    // Parse command line input
-    if (argc < 8)
-    {
-        std::cerr << "Usage: " << argv[0] << " <seed> <temperature> <constant> <cooling-factor> <max-neighbors> <max-iterations> <input-file>" << std::endl;
-        return -1;
-    }
+    return &this->best;
+}
 
-    // Set psudo-random seed
-    srandom(atol(argv[1]));
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+bool BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::isCorrect()
+{
+    return this->correct;
+}
 
-    // Create instance of simulated annealing with given parameters
-    SimulatedAnnealing algorithm(atof(argv[2]), atof(argv[3]), atof(argv[4]), atoi(argv[5]), atoi(argv[6]), argv[7]);
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+unsigned long BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::getIterations()
+{
+    return this->iterations;
+}
 
-    // Run algorithm
-    algorithm.run();
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+double BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::getElapsedSeconds()
+{
+    return this->elapsed_seconds;
+}
 
-    // Exit
-    return 0;
+template <typename Index, typename Moves, typename Acceptance, typename Schedule>
+ElitePool *BasicSimulatedAnnealing<Index, Moves, Acceptance, Schedule>::getElite()
+{
+    return &this->elite;
 }
@@ -0,0 +1,214 @@
+#include "Snapshot.h"
+
+Snapshot::Snapshot()
+{
+    this->value = -1;
+    this->vertex_count = 0;
+    this->width = sizeof(uint16_t);
+}
+
+Snapshot::~Snapshot()
+{
+    // nil
+}
+
+void Snapshot::reserve(unsigned int vertexes)
+{
+    this->colors.reserve(vertexes * sizeof(uint32_t));
+}
+
+template <typename Index>
+void Snapshot::capture(BasicGraph<Index> &graph, unsigned int coloring_value)
+{
+    this->value = coloring_value;
+    this->vertex_count = graph.getVertexCount();
+
+    // Colors go from 0 to V - 1, with -1 for uncolored vertexes
+    this->width = this->vertex_count < UINT16_MAX ? sizeof(uint16_t) : sizeof(uint32_t);
+    this->colors.resize(this->vertex_count * this->width);
+
+    if (this->width == sizeof(uint16_t))
+    {
+        uint16_t *packed = (uint16_t *)this->colors.data();
+        for (unsigned int i = 0; i < this->vertex_count; ++i)
+            packed[i] = graph.getVertex(i)->getColor();
+    }
+    else
+    {
+        uint32_t *packed = (uint32_t *)this->colors.data();
+        for (unsigned int i = 0; i < this->vertex_count; ++i)
+            packed[i] = graph.getVertex(i)->getColor();
+    }
+}
+
+void Snapshot::copyFrom(Snapshot &snapshot)
+{
+    this->value = snapshot.value;
+    this->vertex_count = snapshot.vertex_count;
+    this->width = snapshot.width;
+
+    this->colors.resize(snapshot.colors.size());
+    std::memcpy(this->colors.data(), snapshot.colors.data(), snapshot.colors.size());
+}
+
+template <typename Index>
+void Snapshot::restore(BasicGraph<Index> &graph)
+{
+    graph.clearColoring();
+
+    // The graph numbers its colors densely, so stored colors are
+    // renumbered in order of first appearance
+    std::vector<unsigned int> renumbered(this->vertex_count + 1, -1);
+    unsigned int next = 0;
+
+    for (unsigned int i = 0; i < this->vertex_count; ++i)
+    {
+        unsigned int color = this->getColor(i);
+        if (color == (unsigned int)-1)
+            continue;
+
+        if (renumbered[color] == (unsigned int)-1)
+            renumbered[color] = next++;
+
+        graph.colorVertex(i, renumbered[color]);
+    }
+}
+
+bool Snapshot::fits(unsigned int vertexes)
+{
+    if (this->vertex_count != vertexes || this->colors.size() != (size_t)vertexes * this->width)
+        return false;
+
+    for (unsigned int i = 0; i < this->vertex_count; ++i)
+        if (this->getColor(i) >= vertexes)
+            return false;
+
+    return true;
+}
+
+bool Snapshot::sameColoring(Snapshot &snapshot)
+{
+    return this->colors.size() == snapshot.colors.size() &&
+           std::memcmp(this->colors.data(), snapshot.colors.data(), this->colors.size()) == 0;
+}
+
+unsigned int Snapshot::getValue()
+{
+    return this->value;
+}
+
+unsigned int Snapshot::getVertexCount()
+{
+    return this->vertex_count;
+}
+
+unsigned int Snapshot::getColor(unsigned int vertex_id)
+{
+    if (this->width == sizeof(uint16_t))
+    {
+        uint16_t color = ((uint16_t *)this->colors.data())[vertex_id];
+        return color == UINT16_MAX ? (unsigned int)-1 : color;
+    }
+
+    return ((uint32_t *)this->colors.data())[vertex_id];
+}
+
+void Snapshot::swap(Snapshot &snapshot)
+{
+    std::swap(this->value, snapshot.value);
+    std::swap(this->vertex_count, snapshot.vertex_count);
+    std::swap(this->width, snapshot.width);
+    this->colors.swap(snapshot.colors);
+}
+
+bool Snapshot::write(FILE *file)
+{
+    uint32_t header[3] = {this->value, this->vertex_count, this->width};
+
+    return fwrite(header, sizeof(header), 1, file) == 1 &&
+           fwrite(this->colors.data(), 1, this->colors.size(), file) == this->colors.size();
+}
+
+bool Snapshot::read(FILE *file, unsigned int vertexes)
+{
+    uint32_t header[3];
+
+    if (fread(header, sizeof(header), 1, file) != 1)
+        return false;
+    if (header[1] != vertexes || (header[2] != sizeof(uint16_t) && header[2] != sizeof(uint32_t)))
+        return false;
+    if ((unsigned long)header[1] * header[2] > Snapshot::remainingBytes(file))
+        return false;
+
+    this->value = header[0];
+    this->vertex_count = header[1];
+    this->width = header[2];
+    this->colors.resize((size_t)this->vertex_count * this->width);
+
+    return fread(this->colors.data(), 1, this->colors.size(), file) == this->colors.size();
+}
+
+unsigned long Snapshot::remainingBytes(FILE *file)
+{
+    struct stat info;
+    long position = ftell(file);
+
+    if (position < 0 || fstat(fileno(file), &info) != 0 || position > info.st_size)
+        return 0;
+
+    return info.st_size - position;
+}
+
+void Snapshot::readColoring(std::string filename, unsigned int vertexes)
+{
+    std::ifstream input(filename);
+
+    if (!input.is_open())
+        throw std::runtime_error("Coloring file does not exist!");
+
+    std::vector<unsigned int> coloring;
+    long color;
+
+    while (input >> color)
+    {
+        if (coloring.size() == vertexes)
+            throw std::runtime_error("Coloring file has more colors than vertexes!");
+        if (color < 0)
+            throw std::runtime_error("Coloring file has a negative color!");
+
+        coloring.push_back(color);
+    }
+
+    if (coloring.size() != vertexes)
+        throw std::runtime_error("Coloring file has fewer colors than vertexes!");
+
+    this->assign(coloring);
+}
+
+void Snapshot::assign(const std::vector<unsigned int> &coloring)
+{
+    // Colors are renumbered in order of first appearance
+    std::map<unsigned int, unsigned int> renumbered;
+
+    this->vertex_count = coloring.size();
+    this->width = this->vertex_count < UINT16_MAX ? sizeof(uint16_t) : sizeof(uint32_t);
+    this->colors.resize(this->vertex_count * this->width);
+
+    for (unsigned int i = 0; i < this->vertex_count; ++i)
+    {
+        unsigned int color = renumbered.emplace(coloring[i], renumbered.size()).first->second;
+
+        if (this->width == sizeof(uint16_t))
+            ((uint16_t *)this->colors.data())[i] = color;
+        else
+            ((uint32_t *)this->colors.data())[i] = color;
+    }
+
+    this->value = renumbered.size();
+}
+
+// Both index widths, see Index.h
+template void Snapshot::capture(BasicGraph<uint16_t> &graph, unsigned int coloring_value);
+template void Snapshot::capture(BasicGraph<uint32_t> &graph, unsigned int coloring_value);
+template void Snapshot::restore(BasicGraph<uint16_t> &graph);
+template void Snapshot::restore(BasicGraph<uint32_t> &graph);
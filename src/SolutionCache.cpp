@@ -0,0 +1,129 @@
+#include "SolutionCache.h"
+
+/**
+ * Holds an flock() on a lock file for the lifetime of the object 
+ */
+class FileLock
+{
+private:
+    int descriptor;
+
+public:
+    FileLock(std::string filename, int operation)
+    {
+        this->descriptor = open(filename.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (this->descriptor < 0)
+            throw std::runtime_error("Could not lock solution cache entry!");
+
+        // The destructor does not run when the constructor throws
+        if (flock(this->descriptor, operation) != 0)
+        {
+            close(this->descriptor);
+            throw std::runtime_error("Could not lock solution cache entry!");
+        }
+    }
+
+    ~FileLock()
+    {
+        flock(this->descriptor, LOCK_UN);
+        close(this->descriptor);
+    }
+};
+
+SolutionCache::SolutionCache(std::string directory)
+{
+    this->directory = directory;
+
+    std::filesystem::create_directories(directory);
+}
+
+SolutionCache::~SolutionCache()
+{
+    // nil
+}
+
+std::string SolutionCache::getEntryPath(Graph &graph)
+{
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)graph.getCanonicalHash());
+
+    return (std::filesystem::path(this->directory) / name).string();
+}
+
+bool SolutionCache::readEntry(std::string filename, Graph &graph, Snapshot &coloring)
+{
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file == NULL)
+        return false;
+
+    bool ok = coloring.read(file, graph.getVertexCount());
+    fclose(file);
+
+    if (!ok)
+        return false;
+
+    // Guard against hash collisions and damaged entries
+    std::vector<bool> used(graph.getVertexCount(), false);
+    unsigned int used_count = 0;
+
+    for (unsigned int u = 0; u < graph.getVertexCount(); ++u)
+    {
+        unsigned int color = coloring.getColor(u);
+        if (color >= graph.getVertexCount())
+            return false;
+
+        if (!used[color])
+        {
+            used[color] = true;
+            used_count++;
+        }
+
+        const std::vector<unsigned int> &adjacent = graph.getVertex(u)->getAdjacent();
+        for (auto v = adjacent.begin(); v != adjacent.end(); ++v)
+            if (coloring.getColor(*v) == color)
+                return false;
+    }
+
+    return used_count == coloring.getValue();
+}
+
+bool SolutionCache::lookup(Graph &graph, Snapshot &coloring)
+{
+    std::string entry = this->getEntryPath(graph);
+    FileLock lock(entry + ".lock", LOCK_SH);
+
+    return readEntry(entry + ".sol", graph, coloring);
+}
+
+bool SolutionCache::store(Graph &graph, Snapshot &coloring)
+{
+    std::string entry = this->getEntryPath(graph);
+    FileLock lock(entry + ".lock", LOCK_EX);
+
+    // Keep the known coloring unless the new one is better
+    Snapshot known;
+    if (readEntry(entry + ".sol", graph, known) && known.getValue() <= coloring.getValue())
+        return false;
+
+    // Replace the entry atomically, readers never see a partial file
+    std::string temporary = entry + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if (file == NULL)
+        return false;
+
+    bool ok = coloring.write(file);
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok || rename(temporary.c_str(), (entry + ".sol").c_str()) != 0)
+    {
+        remove(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool SolutionCache::isSolved(Graph &graph, Snapshot &coloring, unsigned int target)
+{
+    return coloring.getValue() <= target || coloring.getValue() <= graph.getCliqueLowerBound();
+}
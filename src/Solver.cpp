@@ -0,0 +1,431 @@
+#include "Solver.h"
+
+// Copies a compact coloring into a result
+static void copyColoring(Snapshot &snapshot, SolverResult &result)
+{
+    result.coloring.resize(snapshot.getVertexCount());
+    for (unsigned int i = 0; i < snapshot.getVertexCount(); ++i)
+        result.coloring[i] = snapshot.getColor(i);
+
+    result.color_count = snapshot.getValue();
+}
+
+Solver::Solver(SolverParameters solver_parameters)
+{
+    this->parameters = solver_parameters;
+}
+
+Solver::~Solver()
+{
+    // nil
+}
+
+void Solver::setProgressCallback(std::function<void(const Progress &)> callback)
+{
+    this->progress_callback = callback;
+}
+
+SolverResult Solver::solve(Graph &graph, Snapshot *initial_coloring)
+{
+    // Nothing to color
+    if (graph.getVertexCount() == 0)
+    {
+        SolverResult result;
+        result.correct = true;
+        result.optimal = true;
+
+        return result;
+    }
+
+    if (this->parameters.order != ORDER_INPUT)
+        return this->solveReordered(graph, initial_coloring);
+    if (this->parameters.decompose)
+        return this->solveComponents(graph, initial_coloring);
+    if (this->parameters.reduce)
+        return this->solveReduced(graph, initial_coloring);
+
+    return this->solveSearch(graph, initial_coloring);
+}
+
+SolverResult Solver::solveSearch(Graph &graph, Snapshot *initial_coloring)
+{
+    SolverResult result;
+
+    if (this->parameters.evolve)
+    {
+        result = this->solveEvolved(graph, initial_coloring);
+    }
+    else
+    {
+        SolverJob job(graph, this->parameters);
+        job.setProgressCallback(this->progress_callback);
+        if (initial_coloring != NULL)
+            job.setInitialColoring(*initial_coloring);
+
+        // Run until finished
+        while (job.step(this->parameters.max_iterations))
+            ;
+
+        result = job.getResult();
+    }
+
+    if (this->parameters.exact && result.correct)
+        this->solveExact(graph, result);
+
+    return result;
+}
+
+void Solver::solveExact(Graph &graph, SolverResult &result)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    BranchAndBound exact(graph);
+
+    Snapshot coloring;
+    coloring.assign(result.coloring);
+    result.optimal = exact.solve(coloring, this->parameters.exact_seconds);
+    result.statistics.exact_nodes = exact.getNodes();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (coloring.getValue() < result.color_count)
+    {
+        copyColoring(coloring, result);
+
+        State *best_state = State::fromSnapshot(graph, coloring);
+        result.correct = best_state->checkCorrectness();
+        delete best_state;
+
+        result.statistics.best_iteration = result.statistics.iterations;
+        result.statistics.best_seconds = result.statistics.elapsed_seconds + seconds;
+    }
+
+    result.statistics.elapsed_seconds += seconds;
+}
+
+SolverResult Solver::solveReordered(Graph &graph, Snapshot *initial_coloring)
+{
+    Reordering reordering(graph, this->parameters.order);
+
+    Snapshot renumbered;
+    if (initial_coloring != NULL)
+        reordering.permute(*initial_coloring, renumbered);
+
+    // Solve the renumbered graph with every other option
+    SolverParameters renumbered_parameters = this->parameters;
+    renumbered_parameters.order = ORDER_INPUT;
+
+    Solver solver(renumbered_parameters);
+    solver.setProgressCallback(this->progress_callback);
+
+    SolverResult result = solver.solve(reordering.getPermuted(), initial_coloring != NULL ? &renumbered : NULL);
+    reordering.restore(result.coloring);
+
+    return result;
+}
+
+SolverResult Solver::solveReduced(Graph &graph, Snapshot *initial_coloring)
+{
+    SolverResult result;
+
+    // Best coloring of the whole graph, initially the given or greedy one,
+    // and the highest number of colors a reduced graph was proven to need
+    Snapshot best;
+    unsigned int lower_bound = 0;
+    if (initial_coloring != NULL)
+    {
+        best.copyFrom(*initial_coloring);
+    }
+    else
+    {
+        Random rng(this->parameters.seed, this->parameters.stream);
+        State *starting_state = State::generateStartingState(graph, rng);
+        best.capture(starting_state->getGraph(), starting_state->getValue());
+        delete starting_state;
+    }
+
+    while (true)
+    {
+        // Only the reduced graph needs fewer colors than the best coloring
+        Reduction reduction(graph, best.getValue());
+        Graph &reduced = reduction.getReduced();
+        result.statistics.removed_vertices = reduction.getRemovedCount();
+
+        Snapshot reduced_best;
+        reduction.restrict(best, reduced_best);
+
+        if (reduced.getVertexCount() > 0)
+        {
+            SolverResult reduced_result = this->solveSearch(reduced, &reduced_best);
+
+            // The whole graph needs at least as many colors as a reduced graph
+            if (reduced_result.optimal)
+                lower_bound = std::max(lower_bound, reduced_result.color_count);
+
+            // Runs follow each other, the best was found during the last one that improved
+            if (reduced_result.color_count < reduced_best.getValue())
+            {
+                result.statistics.best_iteration = result.statistics.iterations + reduced_result.statistics.best_iteration;
+                result.statistics.best_seconds = result.statistics.elapsed_seconds + reduced_result.statistics.best_seconds;
+            }
+
+            result.statistics.iterations += reduced_result.statistics.iterations;
+            result.statistics.elapsed_seconds += reduced_result.statistics.elapsed_seconds;
+            result.statistics.exact_nodes += reduced_result.statistics.exact_nodes;
+
+            reduced_best.assign(reduced_result.coloring);
+        }
+
+        Snapshot full;
+        reduction.expand(reduced_best, full);
+
+        if (full.getValue() >= best.getValue())
+            break;
+
+        best.copyFrom(full);
+
+        // Nothing was removed, reducing again gives the same graph
+        if (reduction.getRemovedCount() == 0)
+            break;
+    }
+
+    copyColoring(best, result);
+    result.optimal = lower_bound >= best.getValue();
+
+    State *best_state = State::fromSnapshot(graph, best);
+    result.correct = best_state->checkCorrectness();
+    delete best_state;
+
+    return result;
+}
+
+SolverResult Solver::solveComponents(Graph &graph, Snapshot *initial_coloring)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    Decomposition decomposition(graph);
+    unsigned int count = decomposition.getComponentCount();
+
+    SolverResult result;
+    result.coloring.assign(graph.getVertexCount(), 0);
+    result.correct = true;
+    result.statistics.components = count;
+
+    // Work of each component, used to share out the neighbors per iteration
+    unsigned long largest = 0;
+    for (unsigned int i = 0; i < count; ++i)
+        largest = std::max(largest, decomposition.getVertexes(i).size() + decomposition.getEdgeCount(i));
+
+    std::vector<SolverResult> results(count);
+    std::atomic<unsigned int> trivial(0);
+
+    auto solve = [&](unsigned int i) {
+        Graph &component = decomposition.getComponent(i);
+        const std::vector<unsigned int> &vertexes = decomposition.getVertexes(i);
+
+        // Cliques and bipartite components need no search
+        if (decomposition.classify(i, results[i].coloring) != COMPONENT_GENERAL)
+        {
+            results[i].color_count = *std::max_element(results[i].coloring.begin(), results[i].coloring.end()) + 1;
+            results[i].correct = true;
+            results[i].optimal = true;
+            trivial++;
+            return;
+        }
+
+        // Smaller components get proportionally fewer neighbors, and their own stream
+        SolverParameters component_parameters = this->parameters;
+        component_parameters.decompose = false;
+        component_parameters.stream = this->parameters.stream + ((unsigned long)(i + 1) << 32);
+        component_parameters.max_neighbors = std::max(1ul, this->parameters.max_neighbors * (vertexes.size() + decomposition.getEdgeCount(i)) / largest);
+
+        Snapshot component_coloring;
+        if (initial_coloring != NULL)
+        {
+            std::vector<unsigned int> restricted(vertexes.size());
+            for (unsigned int v = 0; v < vertexes.size(); ++v)
+                restricted[v] = initial_coloring->getColor(vertexes[v]);
+            component_coloring.assign(restricted);
+        }
+
+        Solver solver(component_parameters);
+        solver.setProgressCallback(this->progress_callback);
+        results[i] = solver.solve(component, initial_coloring != NULL ? &component_coloring : NULL);
+    };
+
+    // Components are sorted largest first, so the pool starts the hardest ones first
+    if (this->parameters.threads == 1 || count <= 1)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+            solve(i);
+    }
+    else
+    {
+        ThreadPool pool(std::min(this->parameters.threads > 0 ? this->parameters.threads : std::thread::hardware_concurrency(), count));
+        for (unsigned int i = 0; i < count; ++i)
+            pool.submit([&solve, i]() { solve(i); });
+        pool.wait();
+    }
+
+    // Merge, every component's colors are renumbered to 0 through k - 1
+    std::vector<unsigned int> numbered_by(graph.getVertexCount(), -1);
+    std::vector<unsigned int> dense_color(graph.getVertexCount());
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const std::vector<unsigned int> &vertexes = decomposition.getVertexes(i);
+        unsigned int used = 0;
+
+        for (unsigned int v = 0; v < vertexes.size(); ++v)
+        {
+            unsigned int color = results[i].coloring[v];
+            if (numbered_by[color] != i)
+            {
+                numbered_by[color] = i;
+                dense_color[color] = used++;
+            }
+            result.coloring[vertexes[v]] = dense_color[color];
+        }
+
+        result.color_count = std::max(result.color_count, used);
+        result.correct = result.correct && results[i].correct;
+        result.statistics.iterations += results[i].statistics.iterations;
+        result.statistics.removed_vertices += results[i].statistics.removed_vertices;
+        result.statistics.exact_nodes += results[i].statistics.exact_nodes;
+        result.statistics.best_iteration = std::max(result.statistics.best_iteration, results[i].statistics.best_iteration);
+        result.statistics.best_seconds = std::max(result.statistics.best_seconds, results[i].statistics.best_seconds);
+    }
+
+    // The graph needs as many colors as its hardest component
+    for (unsigned int i = 0; i < count; ++i)
+        if (results[i].color_count == result.color_count && results[i].optimal)
+            result.optimal = true;
+
+    result.statistics.trivial_components = trivial;
+    result.statistics.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+
+SolverResult Solver::solveEvolved(Graph &graph, Snapshot *initial_coloring)
+{
+    auto start = std::chrono::steady_clock::now();
+    SolverParameters &parameters = this->parameters;
+
+    std::function<void(const Progress &)> &callback = this->progress_callback;
+
+    Evolution evolution(graph, Random(parameters.seed, parameters.stream), [&graph, &parameters, &callback](Random random) {
+        SimulatedAnnealing *run = SimulatedAnnealing::create(graph, random, parameters.temperature, parameters.constant, parameters.cooling_factor,
+                                                             parameters.max_neighbors, parameters.max_iterations, parameters.policies);
+        if (callback)
+            run->setProgressCallback(callback);
+
+        return run;
+    }, parameters.threads);
+
+    evolution.run(parameters.population, parameters.generations, initial_coloring);
+
+    SolverResult result;
+    copyColoring(*evolution.getBest(), result);
+
+    State *best_state = State::fromSnapshot(graph, *evolution.getBest());
+    result.correct = best_state->checkCorrectness();
+    delete best_state;
+
+    result.statistics.iterations = evolution.getIterations();
+    result.statistics.best_iteration = evolution.getBestIteration();
+    result.statistics.best_seconds = evolution.getBestSeconds();
+    result.statistics.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+
+SolverResult Solver::solveEdges(unsigned int vertex_count, const unsigned int *edges, unsigned int edge_count)
+{
+    Graph graph(vertex_count, edges, edge_count);
+
+    return this->solve(graph);
+}
+
+SolverResult Solver::solveCsr(unsigned int vertex_count, const unsigned int *offsets, const unsigned int *targets)
+{
+    Graph graph(vertex_count, offsets, targets);
+
+    return this->solve(graph);
+}
+
+SolverJob *Solver::createJob(Graph &graph)
+{
+    SolverJob *job = new SolverJob(graph, this->parameters);
+    job->setProgressCallback(this->progress_callback);
+
+    return job;
+}
+
+SolverJob::SolverJob(Graph &graph, SolverParameters parameters)
+{
+    this->algorithm = SimulatedAnnealing::create(graph,
+                                                 Random(parameters.seed, parameters.stream),
+                                                 parameters.temperature,
+                                                 parameters.constant,
+                                                 parameters.cooling_factor,
+                                                 parameters.max_neighbors,
+                                                 parameters.max_iterations,
+                                                 parameters.policies);
+}
+
+SolverJob::~SolverJob()
+{
+    delete this->algorithm;
+}
+
+void SolverJob::setProgressCallback(std::function<void(const Progress &)> callback)
+{
+    this->algorithm->setProgressCallback(callback);
+}
+
+void SolverJob::setInitialColoring(Snapshot &coloring)
+{
+    this->algorithm->setInitialColoring(coloring);
+}
+
+bool SolverJob::step(unsigned long n_iterations)
+{
+    return this->algorithm->step(n_iterations);
+}
+
+void SolverJob::cancel()
+{
+    this->algorithm->cancel();
+}
+
+bool SolverJob::isFinished()
+{
+    return this->algorithm->isFinished();
+}
+
+Progress SolverJob::getProgress()
+{
+    return this->algorithm->getProgress();
+}
+
+SolverResult SolverJob::getResult()
+{
+    SolverResult result;
+
+    copyColoring(*this->algorithm->getBest(), result);
+    result.correct = this->algorithm->isCorrect();
+    result.statistics.iterations = this->algorithm->getIterations();
+    result.statistics.elapsed_seconds = this->algorithm->getElapsedSeconds();
+
+    Progress progress = this->algorithm->getProgress();
+    result.statistics.best_iteration = progress.best_iteration;
+    result.statistics.best_seconds = progress.best_seconds;
+
+    return result;
+}
+
+Snapshot *SolverJob::getBest()
+{
+    return this->algorithm->getBest();
+}
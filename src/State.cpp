@@ -1,60 +1,102 @@
 #include "State.h"
 
-State *State::best = NULL;
-
-State::State(Graph graph) : G(graph)
+template <typename Index>
+BasicState<Index>::BasicState(BasicGraph<Index> &graph) : G(graph)
 {
+    INSTRUMENT_COUNT(COUNTER_STATE_ALLOCATIONS);
+
     this->value = 0;
+    this->squared_sizes = 0;
 
     // Compute state value
     this->computeValue();
+
+    // Scratch buffers, the ones indexed by color grow with the number of
+    // colors used instead of being sized by the vertex count
+    this->color_marks.assign(this->value + 1, 0);
+    this->vertex_buffer.reserve(this->G.getVertexCount());
+    this->class_buffer.reserve(this->value);
+    this->mark_stamp = 0;
+}
+
+template <typename Index>
+BasicState<Index>::BasicState(BasicState &state) : BasicState(state.G)
+{
+    // nil
 }
 
-State::~State()
+template <typename Index>
+BasicState<Index>::~BasicState()
 {
     // nil
 }
 
-unsigned int State::computeValue()
+template <typename Index>
+unsigned int BasicState<Index>::computeValue()
 {
     this->value = G.getUsedColorCount();
 
+    this->squared_sizes = 0;
+    for (unsigned int i = 0; i < this->value; ++i)
+    {
+        unsigned long size = this->G.getColor(i)->getUsageCounter();
+        this->squared_sizes += size * size;
+    }
+
     return this->value;
 }
 
-unsigned int State::getValue()
+template <typename Index>
+void BasicState<Index>::copyFrom(BasicState *state)
+{
+    // Vector assignments reuse the capacity already allocated
+    this->G = state->G;
+    this->value = state->value;
+    this->squared_sizes = state->squared_sizes;
+}
+
+template <typename Index>
+unsigned int BasicState<Index>::getValue()
 {
     return this->value;
 }
 
-State *State::getBest()
+template <typename Index>
+BasicState<Index> *BasicState<Index>::fromSnapshot(BasicGraph<Index> &graph, Snapshot &snapshot)
 {
-    return State::best;
+    // Copy graph and apply the coloring
+    BasicGraph<Index> G(graph);
+    snapshot.restore(G);
+
+    return new BasicState(G);
 }
 
-void State::setBest(State *state)
+template <typename Index>
+unsigned long BasicState<Index>::getSquaredSizes()
 {
-    if (State::best != NULL)
-        delete State::best;
+    return this->squared_sizes;
+}
 
-    State::best = new State(state->G);
+template <typename Index>
+BasicGraph<Index> &BasicState<Index>::getGraph()
+{
+    return this->G;
 }
 
-State *State::generateStartingState(Graph graph)
+template <typename Index>
+BasicState<Index> *BasicState<Index>::generateStartingState(BasicGraph<Index> graph, Random &rng)
 {
-    State *starting_state = NULL;
+    BasicState *starting_state = NULL;
 
     // Generate starting state
-    starting_state = State::greedyStart(graph);
-
-    // Update best state
-    State::setBest(starting_state);
+    starting_state = BasicState::greedyStart(graph, rng);
 
     // Return generated state
     return starting_state;
 }
 
-State *State::greedyStart(Graph graph)
+template <typename Index>
+BasicState<Index> *BasicState<Index>::greedyStart(BasicGraph<Index> graph, Random &rng)
 {
     /**
      * Pseudo-Algorithm for generating starting state:
@@ -79,10 +121,10 @@ State *State::greedyStart(Graph graph)
      * 15. endfor
      */
 
-    State *new_state = NULL;
+    BasicState *new_state = NULL;
 
     // Copy graph
-    Graph G(graph);
+    BasicGraph<Index> G(graph);
 
     // Sets with every vertex id
     std::vector<unsigned int> vertex_ids;
@@ -90,7 +132,7 @@ State *State::greedyStart(Graph graph)
         vertex_ids.push_back(i);
 
     // Randomize a vertex
-    unsigned int v_i = random() % vertex_ids.size();
+    unsigned int v_i = rng.next() % vertex_ids.size();
 
     // Give color 0 to vertex
     G.colorVertex(v_i, 0);
@@ -102,7 +144,7 @@ State *State::greedyStart(Graph graph)
     for (unsigned int i = 0; i < G.getVertexCount() - 1; ++i)
     {
         // Sample random vertex
-        v_i = random() % vertex_ids.size();
+        v_i = rng.next() % vertex_ids.size();
 
         // Iterate colors
         for (unsigned int j = 0; j < G.getVertexCount(); ++j)
@@ -123,140 +165,155 @@ State *State::greedyStart(Graph graph)
     }
 
     // Create state with these values
-    new_state = new State(G);
+    new_state = new BasicState(G);
 
     // Return created state
     return new_state;
 }
 
-State *State::generateNeighbor(unsigned int iteration_number, double temperature)
+template <typename Index>
+void BasicState<Index>::nextStamp()
 {
-    // Generate new neighbor with the same graph as this one
-    State *neighbor = new State(this->G);
-
-    // Randomize color given to vertex
-    neighbor->randomizeVertexColor(1);
-
-    if (((double)random() / RAND_MAX) >= 0.8)
-        neighbor->localSearch();
-
-    // If better than best, update best
-    if (neighbor->getValue() < State::best->getValue())
-        State::setBest(neighbor);
-
-    // Return neighbor
-    return neighbor;
+    // Marks left from before the wrap would match the new stamps again
+    if (++this->mark_stamp == 0)
+    {
+        std::fill(this->color_marks.begin(), this->color_marks.end(), 0);
+        this->mark_stamp = 1;
+    }
 }
 
-void State::randomizeVertexColor(unsigned int n)
+template <typename Index>
+void BasicState<Index>::randomizeVertexColor(unsigned int n, Random &rng)
 {
     int v_i = -1;
     int c_i = -1;
-    std::vector<unsigned int> unavailable_colors;
-    std::vector<unsigned int> available_colors;
-    std::vector<unsigned int> adjacency;
-    std::vector<unsigned int> all_colors;
-
-    // Create set with all colors
-    for (unsigned int i = 0; i < this->G.getVertexCount(); ++i)
-        all_colors.push_back(i);
+    unsigned int vertex_count = this->G.getVertexCount();
 
     // Repeat n times
     for (unsigned int i = 0; i < n; ++i)
     {
-        // Reset variables
-        unavailable_colors.clear();
-        available_colors.clear();
-        adjacency.clear();
-
-        // Take a random vertex and get it's adjacency list
-        v_i = random() % this->G.getVertexCount();
-        adjacency = this->G.getVertex(v_i)->getAdjacent();
-
-        // Create set of unavailable colors for that vertex
-        for (unsigned int i = 0; i < adjacency.size(); ++i)
-            unavailable_colors.push_back(this->G.getVertex(adjacency[i])->getColor());
-
-        // Remove duplicates
-        std::set<unsigned int> s(unavailable_colors.begin(), unavailable_colors.end());
-        unavailable_colors.assign(s.begin(), s.end());
-
-        // Sort
-        std::sort(unavailable_colors.begin(), unavailable_colors.end());
+        // Take a random vertex and remove its color, which may renumber the highest color
+        v_i = rng.next() % vertex_count;
+        unsigned long old_size = this->G.getColor(this->G.getVertex(v_i)->getColor())->getUsageCounter();
+        this->G.cleanVertex(v_i);
 
-        // Set diff = available colors
-        std::set_difference(all_colors.begin(), all_colors.end(),
-                            unavailable_colors.begin(), unavailable_colors.end(),
-                            std::inserter(available_colors, available_colors.begin()));
+        // Colors are 0 through k - 1, k opens a new one
+        unsigned int k = this->G.getUsedColorCount();
+        if (this->color_marks.size() <= k)
+            this->color_marks.resize(k + 1, 0);
 
-        // Remove old vertex color
-        this->G.cleanVertex(v_i);
+        // New stamp, colors marked with it are unavailable
+        this->nextStamp();
 
-        // Get random color
-        c_i = random() % available_colors.size();
-        c_i = available_colors[c_i];
+        // Mark the colors used by its adjacency
+        const std::vector<Index> &adjacency = this->G.getVertex(v_i)->getAdjacent();
 
-        // If this is higher than current state value
-        if (c_i > this->value)
+        unsigned int unavailable_count = 0;
+        for (auto j = adjacency.begin(); j != adjacency.end(); ++j)
         {
-            for (int i = available_colors.size() - 1; i >= 0; --i)
+            unsigned int color = this->G.getVertex(*j)->getColor();
+
+            if (color < k && this->color_marks[color] != this->mark_stamp)
             {
-                if (available_colors[i] < this->value)
-                {
-                    c_i = available_colors[i == available_colors.size() - 1 ? i : i + 1];
-                    i = -1;
-                }
+                this->color_marks[color] = this->mark_stamp;
+                unavailable_count++;
             }
         }
 
+        // Get random available color out of every possible one: the r-th
+        // unmarked used color, or a new color, since every color from k
+        // onwards is unused and they are all equivalent
+        unsigned int r = rng.next() % (vertex_count - unavailable_count);
+        if (r < k - unavailable_count)
+        {
+            for (c_i = 0; this->color_marks[c_i] == this->mark_stamp || r-- > 0; ++c_i)
+                ;
+        }
+        else
+        {
+            c_i = k;
+        }
+
         // Give new color to vertex
         this->G.colorVertex(v_i, c_i);
 
-        // Recompute value
-        this->computeValue();
+        // Update value, the sizes change by -1 and +1: (a - 1)^2 - a^2 + b^2 - (b - 1)^2
+        unsigned long new_size = this->G.getColor(c_i)->getUsageCounter();
+        this->value = this->G.getUsedColorCount();
+        this->squared_sizes = this->squared_sizes + 2 * new_size - 2 * old_size;
     }
 
     // Return
     return;
 }
 
-void State::localSearch()
+template <typename Index>
+void BasicState<Index>::iteratedGreedy(Random &rng)
 {
-    // Select random, used color
-    std::vector<Color> used_colors = this->G.getUsedColors();
-    unsigned int c_i = random() % used_colors.size();
-    c_i = used_colors[c_i].getId();
-
-    // Remove that color from every vertex that uses it
-    std::vector<unsigned int> users = this->G.getColor(c_i)->getUsers();
-    for (auto i = users.begin(); i < users.end(); ++i)
+    unsigned int k = this->G.getUsedColorCount();
+    if (this->color_marks.size() <= k)
+        this->color_marks.resize(k + 1, 0);
+
+    // Class order, reverse, largest first and random with weights 5:5:3
+    this->class_buffer.resize(k);
+    for (unsigned int c = 0; c < k; ++c)
+        this->class_buffer[c] = k - 1 - c;
+
+    unsigned int order = rng.next() % 13;
+    if (order >= 10)
+    {
+        for (unsigned int c = k; c > 1; --c)
+            std::swap(this->class_buffer[c - 1], this->class_buffer[rng.next() % c]);
+    }
+    else if (order >= 5)
     {
-        // Remove color
-        this->G.cleanVertex((*i));
+        // Ties in reverse order, std::sort does not allocate
+        std::sort(this->class_buffer.begin(), this->class_buffer.end(), [this](unsigned int a, unsigned int b) {
+            unsigned int a_size = this->G.getColor(a)->getUsageCounter();
+            unsigned int b_size = this->G.getColor(b)->getUsageCounter();
+            return a_size > b_size || (a_size == b_size && a > b);
+        });
+    }
 
-        // Find new color
-        for (unsigned int j = 0; j < this->G.getVertexCount(); ++j)
-        {
-            if (this->G.canUse((*i), j))
-            {
-                // Assign color
-                this->G.colorVertex((*i), j);
+    // Every vertex, class after class
+    this->vertex_buffer.clear();
+    for (auto c = this->class_buffer.begin(); c != this->class_buffer.end(); ++c)
+        for (unsigned int i = this->G.getColor(*c)->getFirstUser(); i != (unsigned int)-1; i = this->G.getVertex(i)->getNextUser())
+            this->vertex_buffer.push_back(i);
 
-                // Exit color looping
-                j = this->G.getVertexCount() + 1;
-            }
+    // Recolor first-fit: a vertex conflicts only with vertexes of earlier
+    // classes, so it never needs more colors than there were classes
+    this->G.clearColoring();
+
+    for (auto i = this->vertex_buffer.begin(); i != this->vertex_buffer.end(); ++i)
+    {
+        this->nextStamp();
+
+        const std::vector<Index> &adjacency = this->G.getVertex(*i)->getAdjacent();
+        for (auto j = adjacency.begin(); j != adjacency.end(); ++j)
+        {
+            unsigned int color = this->G.getVertex(*j)->getColor();
+            if (color != (unsigned int)-1)
+                this->color_marks[color] = this->mark_stamp;
         }
+
+        unsigned int c_i = 0;
+        while (this->color_marks[c_i] == this->mark_stamp)
+            c_i++;
+
+        this->G.colorVertex(*i, c_i);
     }
 
     // Recompute value
     this->computeValue();
 }
 
-bool State::checkCorrectness()
+template <typename Index>
+bool BasicState<Index>::checkCorrectness()
 {
     bool ok = true;
 
-    std::vector<Vertex> vertexes = this->G.getVertexes();
+    std::vector<BasicVertex<Index>> vertexes = this->G.getVertexes();
 
     // Iterate state vertexes
     for (auto i = vertexes.begin(); i != vertexes.end(); ++i)
@@ -278,12 +335,13 @@ bool State::checkCorrectness()
     return ok;
 }
 
-std::string State::toString()
+template <typename Index>
+std::string BasicState<Index>::toString()
 {
     std::stringstream info;
 
     // Iterate vertex list
-    std::vector<Vertex> vertexes = this->G.getVertexes();
+    std::vector<BasicVertex<Index>> vertexes = this->G.getVertexes();
     for (auto i = vertexes.begin(); i != vertexes.end(); ++i)
         // Output color
         std::cout << "[INFO]: Vertex " << (*i).getId() << " has color " << (*i).getColor() << std::endl;
@@ -294,3 +352,7 @@ std::string State::toString()
     // Return
     return info.str();
 }
+
+// Both index widths, see Index.h
+template class BasicState<uint16_t>;
+template class BasicState<uint32_t>;
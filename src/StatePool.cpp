@@ -0,0 +1,64 @@
+#include "StatePool.h"
+
+template <typename Index>
+BasicStatePool<Index>::BasicStatePool(BasicState<Index> *prototype, unsigned int capacity)
+{
+    this->extra_allocations = 0;
+
+    this->states.reserve(capacity);
+    this->available.reserve(capacity);
+
+    for (unsigned int i = 0; i < capacity; ++i)
+    {
+        BasicState<Index> *state = new BasicState<Index>(*prototype);
+
+        this->states.push_back(state);
+        this->available.push_back(state);
+    }
+}
+
+template <typename Index>
+BasicStatePool<Index>::~BasicStatePool()
+{
+    for (auto i = this->states.begin(); i != this->states.end(); ++i)
+        delete (*i);
+}
+
+template <typename Index>
+BasicState<Index> *BasicStatePool<Index>::acquire(BasicState<Index> *source)
+{
+    BasicState<Index> *state = NULL;
+
+    if (this->available.empty())
+    {
+        // Pool exhausted, grow it
+        state = new BasicState<Index>(*source);
+        this->states.push_back(state);
+        this->extra_allocations++;
+    }
+    else
+    {
+        // Recycle an available state
+        state = this->available.back();
+        this->available.pop_back();
+        state->copyFrom(source);
+    }
+
+    return state;
+}
+
+template <typename Index>
+void BasicStatePool<Index>::release(BasicState<Index> *state)
+{
+    this->available.push_back(state);
+}
+
+template <typename Index>
+unsigned long BasicStatePool<Index>::getExtraAllocations()
+{
+    return this->extra_allocations;
+}
+
+// Both index widths, see Index.h
+template class BasicStatePool<uint16_t>;
+template class BasicStatePool<uint32_t>;
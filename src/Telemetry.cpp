@@ -0,0 +1,278 @@
+#include "Telemetry.h"
+
+Telemetry::Telemetry(std::string socket_path, std::string format_name, double refresh_seconds)
+{
+    if (format_name == "prometheus")
+        this->format = TELEMETRY_PROMETHEUS;
+    else if (format_name == "json")
+        this->format = TELEMETRY_JSON;
+    else
+        throw std::runtime_error("Unknown telemetry format '" + format_name + "'!");
+
+    if (refresh_seconds <= 0)
+        throw std::runtime_error("Telemetry interval must be positive!");
+
+    this->path = socket_path;
+    this->interval = refresh_seconds;
+    this->start = std::chrono::steady_clock::now();
+
+    this->sequence.store(0);
+    this->writing.clear();
+    this->steps.store(0);
+    this->iteration.store(0);
+    this->temperature.store(0);
+    this->current_value.store(0);
+    this->best_value.store(0);
+    this->accepted.store(0);
+    this->evaluated.store(0);
+    this->run_seconds.store(0);
+    this->finished.store(false);
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (this->path.empty() || this->path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error("Invalid telemetry socket path!");
+    memcpy(address.sun_path, this->path.c_str(), this->path.size());
+
+    // A socket left behind by a killed run is replaced, any other file is kept
+    struct stat info;
+    if (lstat(this->path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+        unlink(this->path.c_str());
+
+    this->server = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (this->server < 0 || bind(this->server, (sockaddr *)&address, sizeof(address)) != 0 || listen(this->server, 16) != 0)
+    {
+        if (this->server >= 0)
+            close(this->server);
+        throw std::runtime_error("Could not open the telemetry socket " + this->path + "!");
+    }
+
+    if (pipe(this->wake) != 0)
+    {
+        close(this->server);
+        unlink(this->path.c_str());
+        throw std::runtime_error("Could not start the telemetry thread!");
+    }
+
+    this->worker = std::thread(&Telemetry::serve, this);
+}
+
+Telemetry::~Telemetry()
+{
+    char stop = 0;
+    if (write(this->wake[1], &stop, 1) != 1)
+        std::cerr << "[ERROR]: Could not stop the telemetry thread" << std::endl;
+
+    this->worker.join();
+
+    close(this->wake[0]);
+    close(this->wake[1]);
+    close(this->server);
+    unlink(this->path.c_str());
+}
+
+void Telemetry::record(const Progress &progress)
+{
+    // Only one writer at a time, held for a few stores
+    while (this->writing.test_and_set(std::memory_order_acquire))
+        std::this_thread::yield();
+
+    unsigned long current = this->sequence.load(std::memory_order_relaxed);
+    this->sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    this->steps.store(this->steps.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    this->iteration.store(progress.iteration, std::memory_order_relaxed);
+    this->temperature.store(progress.temperature, std::memory_order_relaxed);
+    this->current_value.store(progress.current_value, std::memory_order_relaxed);
+    this->best_value.store(progress.best_value, std::memory_order_relaxed);
+    this->accepted.store(this->accepted.load(std::memory_order_relaxed) + progress.accepted, std::memory_order_relaxed);
+    this->evaluated.store(this->evaluated.load(std::memory_order_relaxed) + progress.evaluated, std::memory_order_relaxed);
+    this->run_seconds.store(progress.elapsed_seconds, std::memory_order_relaxed);
+    this->finished.store(progress.finished, std::memory_order_relaxed);
+
+    this->sequence.store(current + 2, std::memory_order_release);
+
+    this->writing.clear(std::memory_order_release);
+}
+
+std::function<void(const Progress &)> Telemetry::callback()
+{
+    return [this](const Progress &progress) { this->record(progress); };
+}
+
+TelemetrySample Telemetry::read()
+{
+    TelemetrySample sample;
+
+    while (true)
+    {
+        unsigned long before = this->sequence.load(std::memory_order_acquire);
+        if (before % 2 == 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        sample.steps = this->steps.load(std::memory_order_relaxed);
+        sample.iteration = this->iteration.load(std::memory_order_relaxed);
+        sample.temperature = this->temperature.load(std::memory_order_relaxed);
+        sample.current_value = this->current_value.load(std::memory_order_relaxed);
+        sample.best_value = this->best_value.load(std::memory_order_relaxed);
+        sample.accepted = this->accepted.load(std::memory_order_relaxed);
+        sample.evaluated = this->evaluated.load(std::memory_order_relaxed);
+        sample.run_seconds = this->run_seconds.load(std::memory_order_relaxed);
+        sample.finished = this->finished.load(std::memory_order_relaxed);
+
+        // Written meanwhile, read again
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (this->sequence.load(std::memory_order_relaxed) == before)
+            return sample;
+    }
+}
+
+unsigned long Telemetry::residentBytes()
+{
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file == NULL)
+        return 0;
+
+    unsigned long size = 0, resident = 0;
+    if (fscanf(file, "%lu %lu", &size, &resident) != 2)
+        resident = 0;
+    fclose(file);
+
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+std::string Telemetry::serialize(const TelemetrySample &sample, double acceptance_rate, double neighbors_per_second, double elapsed_seconds)
+{
+    std::stringstream text;
+    unsigned long rss = Telemetry::residentBytes();
+
+    if (this->format == TELEMETRY_JSON)
+    {
+        text << "{\"steps\": " << sample.steps
+             << ", \"iteration\": " << sample.iteration
+             << ", \"temperature\": " << sample.temperature
+             << ", \"current_value\": " << sample.current_value
+             << ", \"best_value\": " << sample.best_value
+             << ", \"accepted\": " << sample.accepted
+             << ", \"evaluated\": " << sample.evaluated
+             << ", \"acceptance_rate\": " << acceptance_rate
+             << ", \"neighbors_per_second\": " << neighbors_per_second
+             << ", \"rss_bytes\": " << rss
+             << ", \"run_seconds\": " << sample.run_seconds
+             << ", \"elapsed_seconds\": " << elapsed_seconds
+             << ", \"finished\": " << (sample.finished ? "true" : "false") << "}\n";
+
+        return text.str();
+    }
+
+    auto metric = [&text](const char *name, const char *type, const char *help, double value) {
+        text << "# HELP coloring_" << name << " " << help << "\n"
+             << "# TYPE coloring_" << name << " " << type << "\n"
+             << "coloring_" << name << " " << value << "\n";
+    };
+
+    text.precision(12);
+    metric("steps_total", "counter", "Temperature steps searched.", sample.steps);
+    metric("iteration", "gauge", "Iteration of the current run.", sample.iteration);
+    metric("temperature", "gauge", "Temperature of the current run.", sample.temperature);
+    metric("current_value", "gauge", "Value of the current state.", sample.current_value);
+    metric("best_value", "gauge", "Value of the best state of the current run.", sample.best_value);
+    metric("neighbors_accepted_total", "counter", "Neighbors accepted.", sample.accepted);
+    metric("neighbors_evaluated_total", "counter", "Neighbors evaluated.", sample.evaluated);
+    metric("acceptance_rate", "gauge", "Share of the neighbors accepted over the last interval.", acceptance_rate);
+    metric("neighbors_per_second", "gauge", "Neighbors evaluated per second over the last interval.", neighbors_per_second);
+    metric("resident_memory_bytes", "gauge", "Resident set size of the process.", rss);
+    metric("run_seconds", "gauge", "Search time of the current run.", sample.run_seconds);
+    metric("elapsed_seconds", "gauge", "Time since the telemetry started.", elapsed_seconds);
+    metric("finished", "gauge", "Whether the current run finished.", sample.finished ? 1 : 0);
+
+    return text.str();
+}
+
+void Telemetry::reply(int client, const std::string &snapshot)
+{
+    std::string message = snapshot;
+
+    // HTTP clients send a request first, raw ones only read
+    pollfd request = {client, POLLIN, 0};
+    char buffer[1024];
+    if (poll(&request, 1, 20) == 1 && recv(client, buffer, sizeof(buffer), MSG_DONTWAIT) >= 4 && memcmp(buffer, "GET ", 4) == 0)
+    {
+        std::string type = this->format == TELEMETRY_JSON ? "application/json" : "text/plain; version=0.0.4";
+        message = "HTTP/1.0 200 OK\r\nContent-Type: " + type + "\r\nContent-Length: " + std::to_string(snapshot.size()) + "\r\nConnection: close\r\n\r\n" + snapshot;
+    }
+
+    // A snapshot fits the socket buffer, a stuck client is dropped
+    timeval timeout = {0, 100000};
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    unsigned long sent = 0;
+    while (sent < message.size())
+    {
+        ssize_t count = send(client, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+        if (count <= 0)
+            break;
+        sent += count;
+    }
+}
+
+void Telemetry::serve()
+{
+    TelemetrySample previous = this->read();
+    auto previous_time = this->start;
+    double acceptance_rate = 0, neighbors_per_second = 0;
+    std::string snapshot = this->serialize(previous, 0, 0, 0);
+
+    auto next_refresh = this->start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(this->interval));
+
+    while (true)
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_refresh)
+        {
+            TelemetrySample sample = this->read();
+            double seconds = std::chrono::duration<double>(now - previous_time).count();
+
+            // Rates over the interval, unchanged while no step finished
+            if (sample.evaluated > previous.evaluated)
+            {
+                acceptance_rate = (double)(sample.accepted - previous.accepted) / (sample.evaluated - previous.evaluated);
+                neighbors_per_second = (sample.evaluated - previous.evaluated) / seconds;
+            }
+            else if (sample.finished)
+            {
+                neighbors_per_second = 0;
+            }
+
+            snapshot = this->serialize(sample, acceptance_rate, neighbors_per_second, std::chrono::duration<double>(now - this->start).count());
+
+            previous = sample;
+            previous_time = now;
+            next_refresh = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(this->interval));
+        }
+
+        int timeout = std::chrono::duration_cast<std::chrono::milliseconds>(next_refresh - now).count() + 1;
+
+        pollfd events[2] = {{this->server, POLLIN, 0}, {this->wake[0], POLLIN, 0}};
+        if (poll(events, 2, timeout) < 0)
+            continue;
+
+        if (events[1].revents != 0)
+            return;
+
+        if (events[0].revents & POLLIN)
+        {
+            int client = accept4(this->server, NULL, NULL, SOCK_CLOEXEC);
+            if (client >= 0)
+            {
+                this->reply(client, snapshot);
+                close(client);
+            }
+        }
+    }
+}
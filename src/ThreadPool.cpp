@@ -0,0 +1,76 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned int thread_count)
+{
+    this->pending = 0;
+    this->stopping = false;
+
+    if (thread_count == 0)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int i = 0; i < thread_count; ++i)
+        this->workers.push_back(std::thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+    this->wait();
+
+    // Wake every worker so that they exit
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->work_available.notify_all();
+
+    for (auto i = this->workers.begin(); i != this->workers.end(); ++i)
+        (*i).join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->tasks.push_back(std::move(task));
+        this->pending++;
+    }
+    this->work_available.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    this->all_done.wait(guard, [this]() { return this->pending == 0; });
+}
+
+unsigned int ThreadPool::getThreadCount()
+{
+    return this->workers.size();
+}
+
+void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    while (true)
+    {
+        // The queue is checked under the lock, so no submission is missed
+        this->work_available.wait(guard, [this]() { return !this->tasks.empty() || this->stopping; });
+
+        if (this->tasks.empty())
+            return;
+
+        std::function<void()> task = std::move(this->tasks.front());
+        this->tasks.pop_front();
+
+        guard.unlock();
+        task();
+        task = nullptr;
+        guard.lock();
+
+        // Last task finished, wake waiting threads
+        if (--this->pending == 0)
+            this->all_done.notify_all();
+    }
+}
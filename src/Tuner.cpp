@@ -0,0 +1,492 @@
+#include "Tuner.h"
+
+// Regularized lower incomplete gamma function P(a, x)
+static double regularizedGamma(double a, double x)
+{
+    if (x <= 0)
+        return 0;
+
+    double front = std::exp(-x + a * std::log(x) - std::lgamma(a));
+
+    // Series below a + 1, continued fraction of Q(a, x) above
+    if (x < a + 1)
+    {
+        double term = 1 / a, sum = term;
+        for (unsigned int i = 1; i < 1000 && std::fabs(term) > std::fabs(sum) * 1e-15; ++i)
+        {
+            term *= x / (a + i);
+            sum += term;
+        }
+
+        return sum * front;
+    }
+
+    double tiny = 1e-300;
+    double b = x + 1 - a, c = 1 / tiny, d = 1 / b, h = d;
+    for (unsigned int i = 1; i < 1000; ++i)
+    {
+        double an = -(double)i * (i - a);
+        b += 2;
+        d = an * d + b;
+        d = std::fabs(d) < tiny ? tiny : d;
+        c = b + an / c;
+        c = std::fabs(c) < tiny ? tiny : c;
+        d = 1 / d;
+        h *= d * c;
+        if (std::fabs(d * c - 1) < 1e-15)
+            break;
+    }
+
+    return 1 - front * h;
+}
+
+// Continued fraction of the incomplete beta function
+static double betaFraction(double a, double b, double x)
+{
+    double tiny = 1e-300;
+    double c = 1, d = 1 - (a + b) * x / (a + 1);
+    d = 1 / (std::fabs(d) < tiny ? tiny : d);
+    double h = d;
+
+    for (unsigned int m = 1; m < 1000; ++m)
+    {
+        // Even and odd steps
+        double aa = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));
+        d = 1 + aa * d;
+        d = 1 / (std::fabs(d) < tiny ? tiny : d);
+        c = 1 + aa / c;
+        c = std::fabs(c) < tiny ? tiny : c;
+        h *= d * c;
+
+        aa = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+        d = 1 + aa * d;
+        d = 1 / (std::fabs(d) < tiny ? tiny : d);
+        c = 1 + aa / c;
+        c = std::fabs(c) < tiny ? tiny : c;
+        h *= d * c;
+
+        if (std::fabs(d * c - 1) < 1e-15)
+            break;
+    }
+
+    return h;
+}
+
+// Regularized incomplete beta function I_x(a, b)
+static double regularizedBeta(double a, double b, double x)
+{
+    if (x <= 0)
+        return 0;
+    if (x >= 1)
+        return 1;
+
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1 - x));
+
+    if (x < (a + 1) / (a + b + 2))
+        return front * betaFraction(a, b, x) / a;
+
+    return 1 - front * betaFraction(b, a, 1 - x) / b;
+}
+
+// Point where an increasing distribution function of [0, inf) reaches p
+template <typename Distribution>
+static double quantile(Distribution cdf, double p)
+{
+    double low = 0, high = 1;
+    while (cdf(high) < p)
+        high *= 2;
+
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        double middle = (low + high) / 2;
+        if (cdf(middle) < p)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    return (low + high) / 2;
+}
+
+static double chiSquareQuantile(double p, double df)
+{
+    return quantile([df](double x) { return regularizedGamma(df / 2, x / 2); }, p);
+}
+
+static double studentQuantile(double p, double df)
+{
+    return quantile([df](double t) { return 1 - 0.5 * regularizedBeta(df / 2, 0.5, df / (df + t * t)); }, p);
+}
+
+Tuner::Tuner(SolverParameters parameters, unsigned int threads) : rng(parameters.seed, 1)
+{
+    this->base = parameters;
+    this->thread_count = threads;
+    this->seed_count = 10;
+    this->first_test = 5;
+    this->alpha = 0.05;
+    this->budget = 0;
+    this->evaluations = 0;
+
+    this->space.push_back({"temperature", 0.1, 100, true});
+    this->space.push_back({"constant", 1, 100, true});
+    this->space.push_back({"cooling-factor", 0.9, 0.999, false});
+    this->space.push_back({"max-neighbors", 4, 64, true});
+}
+
+Tuner::~Tuner()
+{
+    for (auto i = this->graphs.begin(); i != this->graphs.end(); ++i)
+        delete *i;
+}
+
+void Tuner::addInstances(std::string path)
+{
+    std::vector<std::string> found = Batch::listInstances(path);
+    this->files.insert(this->files.end(), found.begin(), found.end());
+}
+
+void Tuner::readSpace(std::string filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("Tuning space file does not exist!");
+
+    this->space.clear();
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::stringstream stream(line);
+        TunedParameter parameter;
+        std::string scale;
+
+        if (!(stream >> parameter.name) || parameter.name[0] == '#')
+            continue;
+
+        if (!(stream >> parameter.minimum >> parameter.maximum))
+            throw std::runtime_error("Invalid range of tuned parameter '" + parameter.name + "'!");
+
+        stream >> scale;
+        parameter.logarithmic = scale == "log";
+
+        // Fails for unknown names
+        Tuner::getParameter(this->base, parameter.name);
+
+        if (parameter.minimum > parameter.maximum || (parameter.logarithmic && parameter.minimum <= 0))
+            throw std::runtime_error("Invalid range of tuned parameter '" + parameter.name + "'!");
+
+        this->space.push_back(parameter);
+    }
+
+    if (this->space.empty())
+        throw std::runtime_error("Tuning space has no parameters!");
+}
+
+void Tuner::setRace(unsigned int seeds, unsigned int first, double significance, unsigned long max_evaluations)
+{
+    if (seeds == 0)
+        throw std::runtime_error("Tuning needs at least one seed!");
+    if (significance <= 0 || significance >= 1)
+        throw std::runtime_error("Significance level must be between 0 and 1!");
+
+    this->tasks.clear();
+    this->seed_count = seeds;
+    this->first_test = std::max(first, 2u);
+    this->alpha = significance;
+    this->budget = max_evaluations;
+}
+
+void Tuner::setParameter(SolverParameters &parameters, std::string name, double value)
+{
+    if (name == "temperature")
+        parameters.temperature = value;
+    else if (name == "constant")
+        parameters.constant = value;
+    else if (name == "cooling-factor")
+        parameters.cooling_factor = value;
+    else if (name == "max-neighbors")
+        parameters.max_neighbors = std::max(1.0, std::round(value));
+    else if (name == "max-iterations")
+        parameters.max_iterations = std::max(1.0, std::round(value));
+    else
+        throw std::runtime_error("Unknown tuned parameter '" + name + "'!");
+}
+
+double Tuner::getParameter(const SolverParameters &parameters, std::string name)
+{
+    if (name == "temperature")
+        return parameters.temperature;
+    if (name == "constant")
+        return parameters.constant;
+    if (name == "cooling-factor")
+        return parameters.cooling_factor;
+    if (name == "max-neighbors")
+        return parameters.max_neighbors;
+    if (name == "max-iterations")
+        return parameters.max_iterations;
+
+    throw std::runtime_error("Unknown tuned parameter '" + name + "'!");
+}
+
+void Tuner::sample(unsigned int count)
+{
+    this->candidates.clear();
+
+    for (unsigned int c = 0; c < count; ++c)
+    {
+        Candidate candidate;
+        candidate.parameters = this->base;
+        candidate.alive = true;
+
+        // The given parameters race too
+        for (unsigned int i = 0; c > 0 && i < this->space.size(); ++i)
+        {
+            const TunedParameter &parameter = this->space[i];
+            double u = this->rng.uniform();
+            double value = parameter.logarithmic ? std::exp(std::log(parameter.minimum) + u * (std::log(parameter.maximum) - std::log(parameter.minimum)))
+                                                 : parameter.minimum + u * (parameter.maximum - parameter.minimum);
+
+            Tuner::setParameter(candidate.parameters, parameter.name, value);
+        }
+
+        candidate.colors.assign(this->tasks.size(), 0);
+        candidate.seconds.assign(this->tasks.size(), 0);
+        this->candidates.push_back(candidate);
+    }
+}
+
+void Tuner::evaluate(unsigned int candidate, unsigned int task)
+{
+    unsigned int instance = this->tasks[task].first;
+
+    // Every candidate runs a task with the same seed and stream
+    SolverParameters parameters = this->candidates[candidate].parameters;
+    parameters.seed = this->base.seed + this->tasks[task].second;
+    parameters.stream = instance;
+
+    // Evaluations already run in parallel, their components do not
+    parameters.threads = 1;
+
+    Solver solver(parameters);
+    SolverResult result = solver.solve(*this->graphs[instance], NULL);
+
+    // Invalid colorings lose to every valid one
+    this->candidates[candidate].colors[task] = result.correct ? result.color_count : -1;
+    this->candidates[candidate].seconds[task] = result.statistics.elapsed_seconds;
+}
+
+std::vector<std::vector<double>> Tuner::rank(unsigned int task_count, const std::vector<unsigned int> &alive)
+{
+    std::vector<std::vector<double>> ranks(task_count, std::vector<double>(alive.size()));
+    std::vector<unsigned int> order(alive.size());
+
+    for (unsigned int t = 0; t < task_count; ++t)
+    {
+        for (unsigned int j = 0; j < alive.size(); ++j)
+            order[j] = j;
+
+        auto key = [this, &alive, t](unsigned int j) { return this->candidates[alive[j]].colors[t]; };
+        std::sort(order.begin(), order.end(), [&key](unsigned int a, unsigned int b) { return key(a) < key(b); });
+
+        for (unsigned int first = 0; first < order.size();)
+        {
+            unsigned int last = first;
+            while (last + 1 < order.size() && key(order[last + 1]) == key(order[first]))
+                last++;
+
+            for (unsigned int j = first; j <= last; ++j)
+                ranks[t][order[j]] = (first + last) / 2.0 + 1;
+
+            first = last + 1;
+        }
+    }
+
+    return ranks;
+}
+
+unsigned int Tuner::test(unsigned int task_count)
+{
+    std::vector<unsigned int> alive;
+    for (unsigned int c = 0; c < this->candidates.size(); ++c)
+        if (this->candidates[c].alive)
+            alive.push_back(c);
+
+    double k = alive.size(), n = task_count;
+    if (alive.size() < 2)
+        return 0;
+
+    std::vector<std::vector<double>> ranks = this->rank(task_count, alive);
+
+    // Rank sums, and the sum of the squared ranks
+    std::vector<double> sums(alive.size(), 0);
+    double squares = 0;
+    for (unsigned int t = 0; t < task_count; ++t)
+    {
+        for (unsigned int j = 0; j < alive.size(); ++j)
+        {
+            sums[j] += ranks[t][j];
+            squares += ranks[t][j] * ranks[t][j];
+        }
+    }
+
+    // Friedman statistic, corrected for ties
+    double correction = n * k * (k + 1) * (k + 1) / 4;
+    if (squares - correction <= 0)
+        return 0;
+
+    double deviation = 0, sum_squares = 0;
+    for (unsigned int j = 0; j < alive.size(); ++j)
+    {
+        deviation += (sums[j] - n * (k + 1) / 2) * (sums[j] - n * (k + 1) / 2);
+        sum_squares += sums[j] * sums[j];
+    }
+
+    double statistic = (k - 1) * deviation / (squares - correction);
+    if (statistic <= chiSquareQuantile(1 - this->alpha, k - 1))
+        return 0;
+
+    // Conover's comparisons with the best rank sum
+    double df = (n - 1) * (k - 1);
+    double spread = std::max(0.0, 2 * (n * squares - sum_squares) / df);
+    double critical = studentQuantile(1 - this->alpha / 2, df) * std::sqrt(spread);
+    double best = *std::min_element(sums.begin(), sums.end());
+
+    unsigned int discarded = 0;
+    for (unsigned int j = 0; j < alive.size(); ++j)
+    {
+        if (sums[j] - best > critical)
+        {
+            this->candidates[alive[j]].alive = false;
+            discarded++;
+        }
+    }
+
+    return discarded;
+}
+
+SolverParameters Tuner::run(unsigned int count)
+{
+    if (this->files.empty())
+        throw std::runtime_error("No training instances!");
+    if (count == 0)
+        throw std::runtime_error("Tuning needs at least one candidate!");
+
+    for (unsigned int i = this->graphs.size(); i < this->files.size(); ++i)
+        this->graphs.push_back(new Graph(this->files[i]));
+
+    // Every seed of the instances in a random order
+    std::vector<unsigned int> order(this->files.size());
+    for (unsigned int i = 0; i < order.size(); ++i)
+        order[i] = i;
+    for (unsigned int i = order.size(); i > 1; --i)
+        std::swap(order[i - 1], order[this->rng.next64() % i]);
+
+    this->tasks.clear();
+    for (unsigned int s = 0; s < this->seed_count; ++s)
+        for (unsigned int i = 0; i < order.size(); ++i)
+            this->tasks.push_back(std::make_pair(order[i], s));
+
+    this->sample(count);
+    this->evaluations = 0;
+
+    ThreadPool pool(this->thread_count);
+    unsigned int done = 0;
+
+    while (done < this->tasks.size())
+    {
+        std::vector<unsigned int> alive;
+        for (unsigned int c = 0; c < this->candidates.size(); ++c)
+            if (this->candidates[c].alive)
+                alive.push_back(c);
+
+        if (alive.size() == 1 || (this->budget > 0 && this->evaluations + alive.size() > this->budget))
+            break;
+
+        // Few candidates left run several tasks at once to keep every thread busy
+        unsigned long round = std::max(1ul, (unsigned long)pool.getThreadCount() / alive.size());
+        round = std::min(round, (unsigned long)this->tasks.size() - done);
+        if (this->budget > 0)
+            round = std::min(round, (this->budget - this->evaluations) / alive.size());
+
+        for (unsigned int t = done; t < done + round; ++t)
+            for (auto c = alive.begin(); c != alive.end(); ++c)
+            {
+                unsigned int candidate = *c;
+                pool.submit([this, candidate, t]() { this->evaluate(candidate, t); });
+            }
+
+        pool.wait();
+        this->evaluations += round * alive.size();
+
+        // Tests follow the tasks in order, as if they were run one at a time
+        for (unsigned int t = done; t < done + round; ++t)
+        {
+            if (t + 1 < this->first_test)
+                continue;
+
+            unsigned int discarded = this->test(t + 1);
+            if (discarded > 0)
+            {
+                unsigned int left = std::count_if(this->candidates.begin(), this->candidates.end(), [](const Candidate &c) { return c.alive; });
+                std::cout << "[INFO]: Task " << t + 1 << " of " << this->tasks.size() << ": discarded " << discarded
+                          << " candidates, " << left << " left" << std::endl;
+            }
+        }
+
+        done += round;
+    }
+
+    // Best mean rank among the survivors, then least time
+    std::vector<unsigned int> alive;
+    for (unsigned int c = 0; c < this->candidates.size(); ++c)
+        if (this->candidates[c].alive)
+            alive.push_back(c);
+
+    std::vector<std::vector<double>> ranks = this->rank(done, alive);
+    std::vector<std::pair<double, double>> scores(alive.size(), std::make_pair(0.0, 0.0));
+    for (unsigned int t = 0; t < done; ++t)
+    {
+        for (unsigned int j = 0; j < alive.size(); ++j)
+        {
+            scores[j].first += ranks[t][j];
+            scores[j].second += this->candidates[alive[j]].seconds[t];
+        }
+    }
+
+    unsigned int winner = alive[std::min_element(scores.begin(), scores.end()) - scores.begin()];
+    const Candidate &best = this->candidates[winner];
+
+    double colors = 0, seconds = 0;
+    for (unsigned int t = 0; t < done; ++t)
+    {
+        colors += best.colors[t];
+        seconds += best.seconds[t];
+    }
+
+    std::cout << "[INFO]: " << done << " tasks, " << this->evaluations << " evaluations, " << alive.size() << " candidates left" << std::endl;
+    if (done > 0)
+        std::cout << "[INFO]: Winner uses " << colors / done << " colors in " << seconds / done << " seconds on average" << std::endl;
+
+    return best.parameters;
+}
+
+void Tuner::writeParameters(std::string filename, const SolverParameters &parameters)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+        throw std::runtime_error("Could not write the parameter file!");
+
+    file << "# Raced on " << this->files.size() << " instances and " << this->seed_count << " seeds, " << this->evaluations << " evaluations" << std::endl
+         << "# <seed> " << parameters.temperature << " " << parameters.constant << " " << parameters.cooling_factor << " "
+         << parameters.max_neighbors << " " << parameters.max_iterations << " <input-file>" << std::endl;
+
+    const char *names[] = {"temperature", "constant", "cooling-factor", "max-neighbors", "max-iterations"};
+    for (unsigned int i = 0; i < 5; ++i)
+        file << names[i] << "=" << Tuner::getParameter(parameters, names[i]) << std::endl;
+}
+
+unsigned long Tuner::getEvaluations()
+{
+    return this->evaluations;
+}
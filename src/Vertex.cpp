@@ -1,47 +1,113 @@
 #include "Vertex.h"
 
-Vertex::Vertex(unsigned int vertex_id, unsigned int color_id)
+template <typename Index>
+BasicVertex<Index>::BasicVertex(unsigned int vertex_id, unsigned int color_id)
 {
     this->id = vertex_id;
     this->color = color_id;
+    this->previous_user = -1;
+    this->next_user = -1;
 }
 
-Vertex::~Vertex()
+template <typename Index>
+BasicVertex<Index>::~BasicVertex()
 {
     // nil
 }
 
-std::vector<unsigned int> Vertex::getAdjacent()
+template <typename Index>
+const std::vector<Index> &BasicVertex<Index>::getAdjacent()
 {
     return this->adjacency_list;
 }
 
-void Vertex::setAdjacent(unsigned int vertex_id)
+template <typename Index>
+void BasicVertex<Index>::setAdjacent(unsigned int vertex_id)
 {
     this->adjacency_list.push_back(vertex_id);
 }
 
-void Vertex::setId(unsigned int vertex_id)
+template <typename Index>
+void BasicVertex<Index>::reserveAdjacent(unsigned int count)
+{
+    this->adjacency_list.reserve(count);
+}
+
+template <typename Index>
+bool BasicVertex<Index>::removeAdjacent(unsigned int vertex_id)
+{
+    for (unsigned int i = 0; i < this->adjacency_list.size(); ++i)
+    {
+        if (this->adjacency_list[i] == vertex_id)
+        {
+            this->adjacency_list[i] = this->adjacency_list.back();
+            this->adjacency_list.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Index>
+void BasicVertex<Index>::setId(unsigned int vertex_id)
 {
     this->id = vertex_id;
 }
 
-void Vertex::setColor(unsigned int color_id)
+template <typename Index>
+void BasicVertex<Index>::setColor(unsigned int color_id)
 {
     this->color = color_id;
+    this->previous_user = -1;
+    this->next_user = -1;
+}
+
+template <typename Index>
+void BasicVertex<Index>::setUserLinks(unsigned int previous, unsigned int next)
+{
+    this->previous_user = previous;
+    this->next_user = next;
+}
+
+template <typename Index>
+void BasicVertex<Index>::setNextUser(unsigned int vertex_id)
+{
+    this->next_user = vertex_id;
+}
+
+template <typename Index>
+void BasicVertex<Index>::setPreviousUser(unsigned int vertex_id)
+{
+    this->previous_user = vertex_id;
+}
+
+template <typename Index>
+unsigned int BasicVertex<Index>::getColor()
+{
+    return widenIndex(this->color);
+}
+
+template <typename Index>
+unsigned int BasicVertex<Index>::getPreviousUser()
+{
+    return widenIndex(this->previous_user);
 }
 
-unsigned int Vertex::getColor()
+template <typename Index>
+unsigned int BasicVertex<Index>::getNextUser()
 {
-    return this->color;
+    return widenIndex(this->next_user);
 }
 
-unsigned int Vertex::getId()
+template <typename Index>
+unsigned int BasicVertex<Index>::getId()
 {
     return this->id;
 }
 
-bool Vertex::isAdjacentTo(unsigned int vertex_id)
+template <typename Index>
+bool BasicVertex<Index>::isAdjacentTo(unsigned int vertex_id)
 {
     bool is_adjancent = false;
 
@@ -51,3 +117,7 @@ bool Vertex::isAdjacentTo(unsigned int vertex_id)
 
     return is_adjancent;
 }
+
+// Both index widths, see Index.h
+template class BasicVertex<uint16_t>;
+template class BasicVertex<uint32_t>;
@@ -0,0 +1,472 @@
+#include "Batch.h"
+#include "DynamicColoring.h"
+#include "Generator.h"
+#include "Options.h"
+#include "SimulatedAnnealing.h"
+#include "SolutionCache.h"
+#include "Solver.h"
+#include "Telemetry.h"
+#include "Tuner.h"
+
+// Options listed by usage()
+static const std::vector<std::string> OPTION_NAMES = {
+    "batch", "tune", "output", "generate", "write-graph", "graph-seed", "threads", "glpk", "checkpoint",
+    "checkpoint-interval", "resume", "init-coloring", "cache", "target", "reduce", "components", "order",
+    "evolve", "population", "generations", "objective", "color-weight", "exact", "exact-seconds", "format",
+    "updates", "update-format", "candidates", "tune-space", "tune-seeds", "first-test", "tune-alpha",
+    "tune-budget", "telemetry", "telemetry-format", "telemetry-interval", "moves", "acceptance", "schedule",
+    "history", "initial-acceptance", "stagnation", "reheats"};
+
+/**
+ * @brief Prints the command line usage
+ */
+static void usage(char *program)
+{
+    std::cerr << "Usage: " << program << " [options] <seed> <temperature> <constant> <cooling-factor> <max-neighbors> <max-iterations> <input-file>" << std::endl
+              << "       " << program << " --batch=<manifest-or-directory> [--output=<file>] [options] <seed> <temperature> <constant> <cooling-factor> <max-neighbors> <max-iterations>" << std::endl
+              << "       " << program << " --tune=<manifest-or-directory> [--output=<file>] [options] <seed> <temperature> <constant> <cooling-factor> <max-neighbors> <max-iterations>" << std::endl
+              << "       " << program << " --generate=<graph> [options] <seed> <temperature> <constant> <cooling-factor> <max-neighbors> <max-iterations>" << std::endl
+              << "       " << program << " --generate=<graph> --write-graph=<file> [--graph-seed=<n>]" << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --threads=<n>                      Worker threads (every core by default)" << std::endl
+              << "  --glpk[=<file>]                    Write the GLPK param file of the graph, dense V x V (data.dat)" << std::endl
+              << "  --checkpoint=<file>                Save checkpoints (single annealing run)" << std::endl
+              << "  --checkpoint-interval=<n>          Iterations between checkpoints (100)" << std::endl
+              << "  --resume                           Continue from the checkpoint if it exists" << std::endl
+              << "  --init-coloring=<file>             Start from the given coloring" << std::endl
+              << "  --cache=<dir>                      Best known coloring cache" << std::endl
+              << "  --target=<k>                       Skip the search when the best known coloring uses k colors" << std::endl
+              << "  --reduce                           Remove low degree and dominated vertexes" << std::endl
+              << "  --components                       Color connected components independently" << std::endl
+              << "  --order=<input|degree|bfs|rcm>     Renumber vertexes for cache locality" << std::endl
+              << "  --evolve                           Hybrid evolutionary search, max-iterations per offspring" << std::endl
+              << "  --population=<n>                   Evolutionary search population (10)" << std::endl
+              << "  --generations=<n>                  Evolutionary search generations (50)" << std::endl
+              << "  --objective=<colors|class-sizes>   Value minimized by the search (colors)" << std::endl
+              << "  --color-weight=<w>                 Class sizes objective: weight of the number of colors (0)" << std::endl
+              << "  --exact                            Branch and bound after the search, proving optimality" << std::endl
+              << "  --exact-seconds=<s>                Branch and bound time limit (10)" << std::endl
+              << "  --format=<auto|dimacs|dimacs-binary|edges|metis|mtx>" << std::endl
+              << "                                     Input file format (detected by default), the file may be" << std::endl
+              << "                                     gzip, xz or zstd compressed, or - for the standard input" << std::endl
+              << "  --generate=<graph>                 Generate the graph: gnp:<n>:<p>, queen:<n>, flat:<n>:<k>:<p>," << std::endl
+              << "                                     leighton:<n>:<k>:<edges> or chung-lu:<n>:<average-degree>:<exponent>" << std::endl
+              << "  --graph-seed=<n>                   Seed of the generated graph (1)" << std::endl
+              << "  --write-graph=<file>               Write the generated graph and exit, binary DIMACS if the name ends in .b" << std::endl
+              << "  --updates=<file|->                 Keep the coloring valid through a stream of edge updates" << std::endl
+              << "  --update-format=<text|binary>      Edge update stream format (text)" << std::endl
+              << "  --candidates=<n>                   Tuning: configurations raced, the given one included (16)" << std::endl
+              << "  --tune-space=<file>                Tuning: parameters raced, one \"name minimum maximum [log]\" line each" << std::endl
+              << "  --tune-seeds=<n>                   Tuning: seeds each training instance is run with (10)" << std::endl
+              << "  --first-test=<n>                   Tuning: tasks before the first statistical test (5)" << std::endl
+              << "  --tune-alpha=<a>                   Tuning: significance level of the tests (0.05)" << std::endl
+              << "  --tune-budget=<n>                  Tuning: maximum number of evaluations (no limit)" << std::endl
+              << "  --telemetry=<socket>               Serve live snapshots of the search on a Unix socket" << std::endl
+              << "  --telemetry-format=<prometheus|json>" << std::endl
+              << "                                     Telemetry snapshot format (prometheus)" << std::endl
+              << "  --telemetry-interval=<s>           Seconds between telemetry snapshots (1)" << std::endl
+              << "  --moves=<mixed|recolor>            Neighbor moves (mixed)" << std::endl
+              << "  --acceptance=<metropolis|threshold|late>" << std::endl
+              << "                                     Acceptance rule (metropolis)" << std::endl
+              << "  --schedule=<geometric|linear|lundy-mees|adaptive>" << std::endl
+              << "                                     Cooling schedule (geometric)" << std::endl
+              << "  --history=<n>                      Late acceptance history length (50)" << std::endl
+              << "  --initial-acceptance=<ratio>       Adaptive schedule: initial acceptance of worse neighbors (0.8)" << std::endl
+              << "  --stagnation=<n>                   Adaptive schedule: frozen iterations without improvement before reheating (1000)" << std::endl
+              << "  --reheats=<n>                      Adaptive schedule: fruitless reheats before stopping (1)" << std::endl;
+}
+
+/**
+ * @brief Starts the telemetry given by --telemetry
+ * @returns The telemetry, or NULL if not requested
+ */
+static Telemetry *startTelemetry(Options &options)
+{
+    if (!options.has("telemetry"))
+        return NULL;
+
+    Telemetry *telemetry = new Telemetry(options.get("telemetry"), options.get("telemetry-format", "prometheus"), options.getNumber("telemetry-interval", 1));
+    std::cout << "[INFO]: Serving telemetry on " << options.get("telemetry") << std::endl;
+
+    return telemetry;
+}
+
+/**
+ * @brief Solves every instance of a batch
+ */
+static int runBatch(Options &options, SolverParameters &parameters)
+{
+    Batch batch(parameters, options.getNumber("threads", 0));
+    batch.addInstances(options.get("batch"));
+    if (options.has("cache"))
+        batch.setCache(options.get("cache"), options.getNumber("target", 0));
+
+    std::cout << "[INFO]: Solving " << batch.getInstanceCount() << " instances..." << std::endl;
+
+    unsigned int failed = batch.run(options.get("output", "results.jsonl"));
+
+    std::cout << "[INFO]: Done, " << failed << " failed." << std::endl;
+
+    return failed > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Races parameter configurations on the training instances and
+ * writes the winner
+ */
+static int runTune(Options &options, SolverParameters &parameters)
+{
+    Tuner tuner(parameters, options.getNumber("threads", 0));
+    tuner.addInstances(options.get("tune"));
+    if (options.has("tune-space"))
+        tuner.readSpace(options.get("tune-space"));
+    tuner.setRace(options.getNumber("tune-seeds", 10), options.getNumber("first-test", 5), options.getNumber("tune-alpha", 0.05), options.getNumber("tune-budget", 0));
+
+    std::cout << "[INFO]: Racing " << options.getNumber("candidates", 16) << " configurations..." << std::endl;
+
+    SolverParameters winner = tuner.run(options.getNumber("candidates", 16));
+
+    std::string filename = options.get("output", "tuned.params");
+    tuner.writeParameters(filename, winner);
+
+    std::cout << "[INFO]: Winner: " << winner.temperature << " " << winner.constant << " " << winner.cooling_factor << " "
+              << winner.max_neighbors << " " << winner.max_iterations << ", written to " << filename << std::endl;
+
+    return 0;
+}
+
+/**
+ * @brief Solves one instance through the library solver, for the options
+ * that transform the graph (reordering, reduction, components) or replace
+ * the single run (evolution, branch and bound)
+ */
+static int runSolver(Options &options, SolverParameters &parameters, Graph &G, SolutionCache *cache, Snapshot *known)
+{
+    Snapshot initial;
+    if (options.has("init-coloring"))
+        initial.readColoring(options.get("init-coloring"), G.getVertexCount());
+    else if (known != NULL)
+        initial.copyFrom(*known);
+
+    Telemetry *telemetry = startTelemetry(options);
+
+    Solver solver(parameters);
+    if (telemetry != NULL)
+        solver.setProgressCallback(telemetry->callback());
+    SolverResult result = solver.solve(G, options.has("init-coloring") || known != NULL ? &initial : NULL);
+
+    Snapshot found;
+    found.assign(result.coloring);
+    State *best_state = State::fromSnapshot(G, found);
+
+    if (parameters.decompose)
+        std::cout << "[INFO]: Components: " << result.statistics.components
+                  << " (" << result.statistics.trivial_components << " colored without searching)" << std::endl;
+    if (parameters.reduce)
+        std::cout << "[INFO]: Vertexes removed by the last reduction: " << result.statistics.removed_vertices << std::endl;
+    std::cout << "[INFO]: Best found state uses " << result.color_count << " colors" << std::endl;
+    if (parameters.exact)
+        std::cout << "[INFO]: " << (result.optimal ? "Proven optimal" : "Optimality not proven") << " (" << result.statistics.exact_nodes << " branch and bound nodes)" << std::endl;
+    std::cout << best_state->toString() << std::endl;
+    std::cout << "[INFO]: Finished in " << result.statistics.elapsed_seconds << " seconds" << std::endl
+              << "[INFO]: Total iterations: " << result.statistics.iterations << std::endl
+              << "[INFO]: Best found at iteration " << result.statistics.best_iteration << ", after " << result.statistics.best_seconds << " seconds" << std::endl;
+
+    if (cache != NULL && result.correct && cache->store(G, found))
+        std::cout << "[INFO]: Stored best known state" << std::endl;
+
+    delete best_state;
+    if (telemetry != NULL)
+        delete telemetry;
+
+    return result.correct ? 0 : 1;
+}
+
+/**
+ * @brief Generates the graph given by --generate
+ */
+static Generator *generateGraph(Options &options)
+{
+    Generator *generator = new Generator(options.getNumber("graph-seed", 1));
+
+    auto start = std::chrono::steady_clock::now();
+    generator->generate(options.get("generate"));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "[INFO]: Generated " << options.get("generate") << " with " << generator->getVertexCount() << " vertexes and "
+              << generator->getEdgeCount() << " edges in " << seconds << " seconds" << std::endl;
+
+    return generator;
+}
+
+/**
+ * @brief Colors one instance, then keeps the coloring valid through a
+ * stream of edge updates, timing every update
+ */
+static int runDynamic(Options &options, SolverParameters &parameters, Graph &G)
+{
+    std::string format = options.get("update-format", "text");
+    if (format != "text" && format != "binary")
+        throw std::runtime_error("Unknown update format '" + format + "'!");
+
+    std::ifstream file;
+    if (options.get("updates") != "-")
+    {
+        file.open(options.get("updates"), std::ios::binary);
+        if (!file.is_open())
+            throw std::runtime_error("Could not open the updates file!");
+    }
+    std::istream &stream = file.is_open() ? (std::istream &)file : std::cin;
+
+    DynamicColoring dynamic(G, parameters);
+    std::cout << "[INFO]: Initial coloring uses " << dynamic.getColorCount() << " colors" << std::endl;
+
+    EdgeUpdate update;
+    unsigned long updates = 0;
+    double total_microseconds = 0, max_microseconds = 0;
+
+    while (DynamicColoring::readUpdate(stream, format == "binary", update))
+    {
+        auto start = std::chrono::steady_clock::now();
+        dynamic.apply(update);
+        double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        updates++;
+        total_microseconds += microseconds;
+        max_microseconds = std::max(max_microseconds, microseconds);
+    }
+
+    dynamic.finish();
+
+    DynamicStatistics statistics = dynamic.getStatistics();
+    Snapshot found;
+    found.assign(dynamic.getColoring());
+    State *final_state = State::fromSnapshot(dynamic.getGraph(), found);
+    bool correct = final_state->checkCorrectness();
+
+    std::cout << "[INFO]: Updates: " << updates << " (" << statistics.insertions << " insertions, " << statistics.removals << " removals)" << std::endl
+              << "[INFO]: Conflicts: " << statistics.conflicts << " (" << statistics.free_color_repairs << " free color, "
+              << statistics.kempe_repairs << " Kempe chain, " << statistics.new_color_repairs << " new color)" << std::endl
+              << "[INFO]: Colors emptied by removals: " << statistics.removal_improvements << std::endl
+              << "[INFO]: Background solves: " << statistics.background_passes << " (" << statistics.background_improvements << " improved)" << std::endl
+              << "[INFO]: Update latency: " << (updates > 0 ? total_microseconds / updates : 0) << " us mean, " << max_microseconds << " us max" << std::endl;
+    std::cout << "[INFO]: Final state uses " << dynamic.getColorCount() << " colors" << std::endl;
+    std::cout << final_state->toString() << std::endl;
+
+    delete final_state;
+
+    return correct ? 0 : 1;
+}
+
+/**
+ * @brief Solves one instance with the verbose Simulated Annealing run,
+ * writing the plotting logs and checkpoints
+ */
+static int runAnnealing(Options &options, SolverParameters &parameters, Graph &G, SolutionCache *cache, Snapshot *known)
+{
+    // Create instance of simulated annealing with given parameters
+    SimulatedAnnealing *algorithm = SimulatedAnnealing::create(G, Random(parameters.seed), parameters.temperature, parameters.constant, parameters.cooling_factor, parameters.max_neighbors, parameters.max_iterations, parameters.policies);
+    algorithm->setVerbose(true);
+    algorithm->setLogFiles("log.dat", "neighbors.dat");
+
+    // Live snapshots of the search
+    Telemetry *telemetry = startTelemetry(options);
+    if (telemetry != NULL)
+        algorithm->setProgressCallback(telemetry->callback());
+
+    // Periodic checkpoints
+    std::string checkpoint_filename = options.get("checkpoint", "checkpoint.bin");
+    if (options.has("checkpoint") || options.has("resume"))
+        algorithm->setCheckpoint(checkpoint_filename, options.getNumber("checkpoint-interval", 100));
+
+    // Starting point
+    std::ifstream existing(checkpoint_filename);
+    if (options.has("resume") && existing.good())
+    {
+        Checkpoint checkpoint;
+        checkpoint.read(checkpoint_filename);
+        algorithm->resume(checkpoint);
+
+        std::cout << "[INFO]: Resuming from iteration " << checkpoint.iteration_number << std::endl;
+    }
+    else if (options.has("init-coloring"))
+    {
+        Snapshot coloring;
+        coloring.readColoring(options.get("init-coloring"), G.getVertexCount());
+        algorithm->setInitialColoring(coloring);
+    }
+    else if (known != NULL)
+    {
+        std::cout << "[INFO]: Starting from best known state with " << known->getValue() << " colors" << std::endl;
+        algorithm->setInitialColoring(*known);
+    }
+
+    // Run algorithm
+    algorithm->run();
+
+    // Share improvements with later runs
+    if (cache != NULL && algorithm->isCorrect() && cache->store(G, *algorithm->getBest()))
+        std::cout << "[INFO]: Stored best known state" << std::endl;
+
+    bool correct = algorithm->isCorrect();
+
+    delete algorithm;
+    if (telemetry != NULL)
+        delete telemetry;
+
+    return correct ? 0 : 1;
+}
+
+/**
+ * ./app [options] <seed> <temperature> <constant> <cooling-factor> <max-neighbors> <max-iterations> <input-file>
+ * ./app --batch=<manifest-or-directory> [--output=<file>] [options] <seed> <temperature> <constant> <cooling-factor> <max-neighbors> <max-iterations>
+ */
+int main(int argc, char **argv)
+{
+    Options options(argc, argv);
+    const std::vector<std::string> &arguments = options.getArguments();
+
+    // Misspelled options would otherwise be ignored
+    std::string unknown = options.findUnknown(OPTION_NAMES);
+    if (!unknown.empty())
+    {
+        std::cerr << "[ERROR]: Unknown option --" << unknown << "!" << std::endl;
+        usage(argv[0]);
+        return -1;
+    }
+
+    // Parse command line input
+    unsigned int required = options.has("batch") || options.has("tune") || options.has("generate") ? 6 : 7;
+    if (options.has("generate") && options.has("write-graph"))
+        required = 0;
+
+    if (arguments.size() < required)
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    // Write instrumentation summary when the process exits
+    INSTRUMENT_DUMP_AT_EXIT("instrumentation.json");
+
+    try
+    {
+        // Write a generated graph only
+        if (options.has("generate") && options.has("write-graph"))
+        {
+            Generator *generator = generateGraph(options);
+            std::string filename = options.get("write-graph");
+
+            if (filename.size() > 2 && filename.compare(filename.size() - 2, 2, ".b") == 0)
+                generator->writeBinary(filename);
+            else
+                generator->writeDimacs(filename);
+
+            std::cout << "[INFO]: Wrote " << filename << std::endl;
+
+            delete generator;
+            return 0;
+        }
+
+        // Algorithm parameters
+        SolverParameters parameters;
+        parameters.seed = atol(arguments[0].c_str());
+        parameters.temperature = atof(arguments[1].c_str());
+        parameters.constant = atof(arguments[2].c_str());
+        parameters.cooling_factor = atof(arguments[3].c_str());
+        parameters.max_neighbors = atoi(arguments[4].c_str());
+        parameters.max_iterations = atoi(arguments[5].c_str());
+        parameters.reduce = options.has("reduce");
+        parameters.decompose = options.has("components");
+        parameters.threads = options.getNumber("threads", 0);
+        parameters.order = Reordering::parse(options.get("order", "input"));
+        parameters.evolve = options.has("evolve");
+        parameters.exact = options.has("exact");
+        parameters.exact_seconds = options.getNumber("exact-seconds", parameters.exact_seconds);
+        parameters.population = options.getNumber("population", parameters.population);
+        parameters.generations = options.getNumber("generations", parameters.generations);
+        parameters.policies.objective = options.get("objective", parameters.policies.objective);
+        parameters.policies.color_weight = options.getNumber("color-weight", parameters.policies.color_weight);
+        parameters.policies.moves = options.get("moves", parameters.policies.moves);
+        parameters.policies.acceptance = options.get("acceptance", parameters.policies.acceptance);
+        parameters.policies.schedule = options.get("schedule", parameters.policies.schedule);
+        parameters.policies.history_length = options.getNumber("history", parameters.policies.history_length);
+        parameters.policies.initial_acceptance = options.getNumber("initial-acceptance", parameters.policies.initial_acceptance);
+        parameters.policies.stagnation_steps = options.getNumber("stagnation", parameters.policies.stagnation_steps);
+        parameters.policies.max_reheats = options.getNumber("reheats", parameters.policies.max_reheats);
+        SimulatedAnnealing::checkPolicies(parameters.policies);
+
+        // Checkpoints belong to a single annealing run, see runAnnealing()
+        bool single_run = !options.has("batch") && !options.has("tune") && !options.has("updates") &&
+                          parameters.order == ORDER_INPUT && !parameters.reduce && !parameters.decompose && !parameters.evolve && !parameters.exact;
+        if ((options.has("checkpoint") || options.has("resume")) && !single_run)
+            throw std::runtime_error("Checkpoints are not supported with --batch, --tune, --updates, --order, --reduce, --components, --evolve or --exact!");
+
+        // Batch mode
+        if (options.has("batch"))
+            return runBatch(options, parameters);
+
+        // Tuning mode
+        if (options.has("tune"))
+            return runTune(options, parameters);
+
+        // Read or generate input graph
+        Graph *graph = NULL;
+        if (options.has("generate"))
+        {
+            Generator *generator = generateGraph(options);
+            graph = generator->build();
+            delete generator;
+        }
+        else
+        {
+            graph = new Graph(arguments[6], GraphReader::parse(options.get("format", "auto")));
+        }
+        Graph &G = *graph;
+
+        // Write GLPK-ready param file, a dense matrix, only on request
+        if (options.has("glpk"))
+            G.exportGlpk(options.get("glpk").empty() ? "data.dat" : options.get("glpk"));
+
+        // Best known coloring
+        SolutionCache *cache = options.has("cache") ? new SolutionCache(options.get("cache")) : NULL;
+        Snapshot known;
+        bool cached = cache != NULL && cache->lookup(G, known);
+
+        int status = 0;
+
+        if (options.has("updates"))
+        {
+            status = runDynamic(options, parameters, G);
+        }
+        else if (cached && SolutionCache::isSolved(G, known, options.getNumber("target", 0)))
+        {
+            State *known_state = State::fromSnapshot(G, known);
+
+            std::cout << "[INFO]: Best known state uses " << known.getValue() << " colors, nothing to search" << std::endl;
+            std::cout << known_state->toString() << std::endl;
+
+            delete known_state;
+        }
+        else if (!single_run)
+        {
+            status = runSolver(options, parameters, G, cache, cached ? &known : NULL);
+        }
+        else
+        {
+            status = runAnnealing(options, parameters, G, cache, cached ? &known : NULL);
+        }
+
+        if (cache != NULL)
+            delete cache;
+        delete graph;
+
+        return status;
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << "[ERROR]: " << e.what() << std::endl;
+        return -1;
+    }
+}